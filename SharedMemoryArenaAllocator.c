@@ -0,0 +1,520 @@
+/* ============================================================================ **
+ **                           Embedded Linux                                     **
+ ** ============================================================================ **
+ **               +++++++++++++++++++++++++++++++++++++++                        **
+ **    Module:    +    SharedMemoryArenaAllocator.c     +                        **
+ **               +++++++++++++++++++++++++++++++++++++++                        **
+ **                                                                              **
+ **  Description: This module implements an arena allocator inside the shared    **
+ **               memory segment: size classes with lock-free free lists and     **
+ **               self-relative offset pointers for linked structures shared     **
+ **               among processes that attach the segment at different address   **
+ **                                                                              **
+ ** ============================================================================ **
+ **         Edit                                      Data           Author      **
+ **    First release                                18/10/2026     F.Coppo       **
+ ** ============================================================================ */
+
+// Include .
+#include <stdio.h>
+#include <sys/shm.h>
+#include <errno.h>
+#include <sys/wait.h>
+#include <stdbool.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <time.h>
+
+// Define .
+#define SHARED_MEM_ID          111
+#define ARENA_SIZE             (4*1024*1024)
+#define ARENA_MAGIC            0x41524E41u
+#define CLASS_NUMBER           8
+#define CLASS_MIN_SHIFT        5
+#define BLOCK_HEADER           16
+#define LIST_NODES             1000
+#define WORKER_NUMBER          2
+#define ALLOC_CYCLES           200000
+#define LIVE_BLOCKS            64
+#define NSEC_PER_SEC 1000000000LL
+
+// Self-relative offset pointer: distance from its own address (0 is NULL) .
+typedef int64_t offPtr_t;
+
+// Free list head: ABA tag (high 32 bits) and arena offset of the first block (low 32 bits) .
+typedef _Atomic uint64_t freeHead_t;
+
+// Block header (arena offset of the next free block while the block is free) .
+typedef struct
+{
+	uint32_t sizeClass;
+	uint32_t magic;
+	uint64_t next;
+} blockHeader_t;
+
+// Arena header at the beginning of the segment .
+typedef struct
+{
+	uint32_t           magic;
+	uint32_t           size;
+	_Atomic uint32_t   brk;
+	freeHead_t         freeList[CLASS_NUMBER];
+	_Atomic uint64_t   allocCount[CLASS_NUMBER];
+	_Atomic uint64_t   freeCount[CLASS_NUMBER];
+	offPtr_t           root;
+} arenaHeader_t;
+
+// Linked list node built by the parent and read by the workers .
+typedef struct
+{
+	offPtr_t  next;
+	long long value;
+} listNode_t;
+
+// Local variables .
+static int childPid = 0;
+
+// Callback linked to SIGINT signal .
+void endProcessesSignaller (int sig_num)
+{
+	if (childPid == 0)
+	{
+		// Child kill request .
+		printf("Child kill request (pid %d)\n", (int) getpid());
+		printf("Child killing...\n");
+		kill(getpid(), SIGUSR1);
+	}
+	else
+	{
+		// Father kill request: the whole process group is killed .
+		printf("Father kill request (pid %d)\n", (int) getpid());
+		printf("Workers killing...\n");
+		kill(0, SIGUSR1);
+	}
+}
+
+// Monotonic time in nanoseconds .
+static long long timeNowNs (void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (long long) ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+// Offset pointer read .
+static inline void * offPtrGet (offPtr_t * ptr)
+{
+	return (*ptr == 0) ? NULL : (void *) ((char *) ptr + *ptr);
+}
+
+// Offset pointer write .
+static inline void offPtrSet (offPtr_t * ptr, void * target)
+{
+	*ptr = (target == NULL) ? 0 : (offPtr_t) ((char *) target - (char *) ptr);
+}
+
+// Size class of a request (-1 when too large) .
+static int arenaSizeClass (size_t size)
+{
+	int sizeClass;
+
+	for (sizeClass=0; sizeClass < CLASS_NUMBER; sizeClass++)
+	{
+		if (size + BLOCK_HEADER <= ((size_t) 1 << (sizeClass + CLASS_MIN_SHIFT)))
+		{
+			return sizeClass;
+		}
+	}
+
+	return -1;
+}
+
+// Arena initialization (creator only) .
+static void arenaInit (arenaHeader_t * arena, uint32_t size)
+{
+	int i;
+
+	memset(arena, 0, sizeof(arenaHeader_t));
+
+	arena->size = size;
+	atomic_init(&arena->brk, (sizeof(arenaHeader_t) + 63) & ~63u);
+
+	for (i=0; i < CLASS_NUMBER; i++)
+	{
+		atomic_init(&arena->freeList[i], 0);
+		atomic_init(&arena->allocCount[i], 0);
+		atomic_init(&arena->freeCount[i], 0);
+	}
+
+	arena->root = 0;
+	arena->magic = ARENA_MAGIC;
+}
+
+// Lock-free allocation: free list pop, bump pointer when the list is empty .
+static void * arenaAlloc (arenaHeader_t * arena, size_t size)
+{
+	char * base = (char *) arena;
+	int sizeClass = arenaSizeClass(size);
+	uint32_t blockSize, offset;
+	uint64_t head, newHead;
+	blockHeader_t * block;
+
+	if (sizeClass < 0)
+	{
+		return NULL;
+	}
+
+	blockSize = 1u << (sizeClass + CLASS_MIN_SHIFT);
+
+	// Free list pop (the tag changes at each update, so a recycled head fails the CAS) .
+	head = atomic_load_explicit(&arena->freeList[sizeClass], memory_order_acquire);
+
+	while ((uint32_t) head != 0)
+	{
+		block = (blockHeader_t *) (base + (uint32_t) head);
+		newHead = (((head >> 32) + 1) << 32) | (uint32_t) block->next;
+
+		if (atomic_compare_exchange_weak_explicit(&arena->freeList[sizeClass], &head, newHead, memory_order_acquire, memory_order_acquire))
+		{
+			atomic_fetch_add_explicit(&arena->allocCount[sizeClass], 1, memory_order_relaxed);
+			return (char *) block + BLOCK_HEADER;
+		}
+	}
+
+	// Bump allocation: brk only advances while the block fits, so an exhausted arena never wraps it .
+	offset = atomic_load_explicit(&arena->brk, memory_order_relaxed);
+
+	do
+	{
+		if ((offset > arena->size) || (blockSize > arena->size - offset))
+		{
+			return NULL;
+		}
+	}
+	while (!atomic_compare_exchange_weak_explicit(&arena->brk, &offset, offset + blockSize, memory_order_relaxed, memory_order_relaxed));
+
+	block = (blockHeader_t *) (base + offset);
+	block->sizeClass = (uint32_t) sizeClass;
+	block->magic = ARENA_MAGIC;
+
+	atomic_fetch_add_explicit(&arena->allocCount[sizeClass], 1, memory_order_relaxed);
+
+	return (char *) block + BLOCK_HEADER;
+}
+
+// Lock-free free: push on the free list of the block size class .
+static void arenaFree (arenaHeader_t * arena, void * ptr)
+{
+	char * base = (char *) arena;
+	blockHeader_t * block;
+	uint64_t head, newHead;
+	uint32_t offset;
+
+	if (ptr == NULL)
+	{
+		return;
+	}
+
+	block = (blockHeader_t *) ((char *) ptr - BLOCK_HEADER);
+	offset = (uint32_t) ((char *) block - base);
+
+	if ((block->magic != ARENA_MAGIC) || (block->sizeClass >= CLASS_NUMBER))
+	{
+		printf("arena: invalid free at offset %u\n", offset);
+		return;
+	}
+
+	head = atomic_load_explicit(&arena->freeList[block->sizeClass], memory_order_relaxed);
+
+	do
+	{
+		block->next = (uint32_t) head;
+		newHead = (((head >> 32) + 1) << 32) | offset;
+	}
+	while (!atomic_compare_exchange_weak_explicit(&arena->freeList[block->sizeClass], &head, newHead, memory_order_release, memory_order_relaxed));
+
+	atomic_fetch_add_explicit(&arena->freeCount[block->sizeClass], 1, memory_order_relaxed);
+}
+
+// Memory creation .
+static int sharedMemCreation (key_t key)
+{
+	struct shmid_ds shmds;
+
+	int shmid = shmget(key, ARENA_SIZE, 0666 | IPC_CREAT);
+
+	if (shmid >= 0)
+	{
+		// Info request .
+		if (shmctl(shmid, IPC_STAT, &shmds) == 0)
+		{
+			printf("%d bytes size shared memory created\n", (int) shmds.shm_segsz);
+		}
+		else
+		{
+			printf("shmctl error = %d\n", errno);
+		}
+	}
+	else
+	{
+		printf("PARENT: shared memory segment not found.\n");
+		exit(-1);
+	}
+
+	return shmid;
+}
+
+// Memory context attaching .
+static bool sharedMemAttach (int shmid, int role, arenaHeader_t * * ptPtMem)
+{
+	struct shmid_ds shmds;
+	bool success = true;
+
+	// Attach shmid memory .
+	*ptPtMem = (arenaHeader_t *) shmat(shmid, (const void *)0, 0);
+
+	// Info request .
+	if ((*ptPtMem != (arenaHeader_t *) -1) && (shmctl(shmid, IPC_STAT, &shmds) == 0))
+	{
+		printf("%s: context attached at %p (currently %d attaches)\n", ((role == 0) ? "PARENT" : " CHILD"), (void *) *ptPtMem, (int) shmds.shm_nattch);
+	}
+	else
+	{
+		printf("%s: shmctl error = %d\n",((role == 0) ? "PARENT" : " CHILD"), errno);
+		success = false;
+	}
+
+	return success;
+}
+
+// Memory context detaching .
+static void sharedMemDetaches(arenaHeader_t * ptMem, int shmid, int role)
+{
+	struct shmid_ds shmds;
+
+	if (shmdt(ptMem) == -1)
+	{
+		printf("%s: memory detaching error(%d)\n", ((role == 0) ? "PARENT" : " CHILD"), errno);
+	}
+	else
+	{
+		// Update info .
+		if(shmctl(shmid, IPC_STAT, &shmds) == 0)
+		{
+			printf("%s: memory (created by pid %d) detached (currently remaining %d attached)\n", ((role == 0) ? "PARENT" : " CHILD"), (int) shmds.shm_cpid, (int) shmds.shm_nattch);
+		}
+		else
+		{
+			printf("%s: shmctl error=%d\n", ((role == 0) ? "PARENT" : " CHILD"), errno);
+		}
+	}
+}
+
+// Parent: linked list built inside the arena and published through the root pointer .
+static long long listBuild (arenaHeader_t * arena)
+{
+	listNode_t * node;
+	long long sum = 0;
+	int i;
+
+	for (i=0; i < LIST_NODES; i++)
+	{
+		node = (listNode_t *) arenaAlloc(arena, sizeof(listNode_t));
+
+		if (node == NULL)
+		{
+			printf("PARENT: arena exhausted\n");
+			break;
+		}
+
+		node->value = (long long) i * 3;
+		sum += node->value;
+
+		// Head insertion .
+		node->next = 0;
+		offPtrSet(&node->next, offPtrGet(&arena->root));
+		offPtrSet(&arena->root, node);
+	}
+
+	return sum;
+}
+
+// Worker: list walk from its own mapping .
+static long long listWalk (arenaHeader_t * arena)
+{
+	listNode_t * node = (listNode_t *) offPtrGet(&arena->root);
+	long long sum = 0;
+
+	while (node != NULL)
+	{
+		sum += node->value;
+		node = (listNode_t *) offPtrGet(&node->next);
+	}
+
+	return sum;
+}
+
+// Worker: concurrent allocate/free with ownership check of every live block .
+static unsigned int allocStress (arenaHeader_t * arena, int worker)
+{
+	unsigned char * live[LIVE_BLOCKS] = { NULL };
+	size_t liveSize[LIVE_BLOCKS] = { 0 };
+	unsigned int seed = (unsigned int) getpid();
+	unsigned int errors = 0;
+	unsigned char pattern = (unsigned char) (0xA0 + worker);
+	size_t k;
+	int cycle, slot;
+
+	for (cycle=0; cycle < ALLOC_CYCLES; cycle++)
+	{
+		slot = rand_r(&seed) % LIVE_BLOCKS;
+
+		if (live[slot] != NULL)
+		{
+			// Nobody else may have written into a block owned by this worker .
+			for (k=0; k < liveSize[slot]; k++)
+			{
+				if (live[slot][k] != pattern)
+				{
+					errors++;
+					break;
+				}
+			}
+
+			arenaFree(arena, live[slot]);
+			live[slot] = NULL;
+		}
+		else
+		{
+			liveSize[slot] = 8 + (size_t) (rand_r(&seed) % 1000);
+			live[slot] = (unsigned char *) arenaAlloc(arena, liveSize[slot]);
+
+			if (live[slot] != NULL)
+			{
+				memset(live[slot], pattern, liveSize[slot]);
+			}
+		}
+	}
+
+	for (slot=0; slot < LIVE_BLOCKS; slot++)
+	{
+		arenaFree(arena, live[slot]);
+	}
+
+	return errors;
+}
+
+// Main routine .
+int main()
+{
+	int shmid, retFork, status, worker, i;
+	arenaHeader_t * arena = NULL;
+	int role = -1;
+	long long expected;
+
+	// Signal callback registration .
+	signal(SIGINT, endProcessesSignaller);
+
+	// Shared memory create .
+	shmid = sharedMemCreation(SHARED_MEM_ID);
+
+	// Parent attach, arena initialization and list building .
+	role = 0;
+
+	if (!sharedMemAttach(shmid, role, &arena))
+	{
+		exit(-1);
+	}
+
+	arenaInit(arena, ARENA_SIZE);
+	expected = listBuild(arena);
+
+	printf("PARENT: %d nodes list built (sum %lld)\n", LIST_NODES, expected);
+
+	// Workers creation .
+	for (worker=0; worker < WORKER_NUMBER; worker++)
+	{
+		fflush(stdout);
+		retFork = fork();
+
+		if (retFork == 0)
+		{
+			arenaHeader_t * inherited = arena;
+			unsigned int errors;
+			long long sum, start;
+
+			role = 1;
+			childPid = 0;
+
+			printf(" CHILD: child process created (pid %d)\n", (int) getpid());
+
+			// Keep identifier of the shared memory segment and attach a new mapping .
+			shmid = shmget(SHARED_MEM_ID, 0, 0);
+
+			if ( sharedMemAttach(shmid, role, &arena) )
+			{
+				// The inherited mapping is dropped: only offsets are meaningful from now on .
+				sharedMemDetaches(inherited, shmid, role);
+
+				sum = listWalk(arena);
+				printf(" CHILD: list walk from %p, sum %lld (%s)\n", (void *) arena, sum, (sum == expected) ? "ok" : "ERROR");
+
+				start = timeNowNs();
+				errors = allocStress(arena, worker);
+				printf(" CHILD: %d alloc/free cycles, %lld ns/cycle, %u ownership errors\n", ALLOC_CYCLES, (timeNowNs() - start) / ALLOC_CYCLES, errors);
+
+				sharedMemDetaches(arena, shmid, role);
+			}
+
+			printf(" CHILD: Exiting...\n");
+			fflush(stdout);
+
+			exit(0);
+		}
+		else if (retFork > 0)
+		{
+			childPid = retFork;
+		}
+		else
+		{
+			printf("PARENT: error trying to fork() (%d)\n", errno);
+		}
+	}
+
+	// Wait workers ending before delete memory .
+	while (wait(&status) > 0)
+	{
+	}
+
+	// Arena statistics .
+	printf("PARENT: arena used %u of %u bytes\n", (unsigned int) atomic_load(&arena->brk), arena->size);
+
+	for (i=0; i < CLASS_NUMBER; i++)
+	{
+		printf("PARENT: class %5d bytes: %8llu alloc, %8llu free\n", 1 << (i + CLASS_MIN_SHIFT), (unsigned long long) atomic_load(&arena->allocCount[i]), (unsigned long long) atomic_load(&arena->freeCount[i]));
+	}
+
+	// Detaching memory .
+	sharedMemDetaches(arena, shmid, role);
+
+	// Removing memory .
+	if (shmctl( shmid, IPC_RMID, 0 ) == 0)
+	{
+		printf( "PARENT: memory segment removed\n");
+	}
+	else
+	{
+		printf( "PARENT: memory segment removing fail!\n" );
+	}
+
+	printf("PARENT: Exiting...\n");
+	fflush(stdout);
+
+	return 0;
+}
@@ -0,0 +1,816 @@
+/* ============================================================================ **
+ **                           Embedded Linux                                     **
+ ** ============================================================================ **
+ **               +++++++++++++++++++++++++++++++++++++++                        **
+ **    Module:    +     SharedMemoryCaptureReplay.c     +                        **
+ **               +++++++++++++++++++++++++++++++++++++++                        **
+ **                                                                              **
+ **  Description: This module implements capture and replay of the traffic of a  **
+ **               shared memory channel: a recorder process drains the channel   **
+ **               into an append-only memory mapped file (header, index, data)   **
+ **               and a replayer feeds it back at original timing or full speed  **
+ **                                                                              **
+ ** ============================================================================ **
+ **         Edit                                      Data           Author      **
+ **    First release                                18/10/2026     F.Coppo       **
+ ** ============================================================================ */
+
+// Include .
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <sys/shm.h>
+#include <errno.h>
+#include <sys/wait.h>
+#include <stdbool.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <sys/sem.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+
+// Define .
+#define SHARED_MEM_ID          111
+#define SEM_ID                 112
+#define MSG_MAX                256
+#define MSG_MIN                16
+#define CHANNEL_SLOTS          64
+#define MESSAGE_NUMBER         100000
+#define BURST_MESSAGES         1000
+#define USLEEP_BURST_MS        1000
+#define END_OF_STREAM          -1LL
+#define CAPTURE_MAGIC          0x50434D53u
+#define CAPTURE_VERSION        1
+#define INDEX_CAPACITY         (1 << 18)
+#define DATA_CAPACITY          (64*1024*1024)
+#define NSEC_PER_SEC 1000000000LL
+#define NSEC_PER_MS     1000000LL
+#define STALL_THRESHOLD_MS     500
+
+// Semaphores of the channel .
+#define SEM_EMPTY              0
+#define SEM_FULL               1
+
+// Message moved through the channel .
+typedef struct
+{
+	long long     seq;
+	long long     timeNs;
+	int           length;
+	unsigned char data[MSG_MAX];
+} message_t;
+
+// Ring channel (single producer, single consumer) .
+typedef struct
+{
+	unsigned int head;
+	unsigned int tail;
+	message_t    slot[CHANNEL_SLOTS];
+} channel_t;
+
+// Capture file header .
+typedef struct
+{
+	uint32_t magic;
+	uint16_t version;
+	uint16_t headerSize;
+	uint64_t recordCount;
+	uint64_t indexOffset;
+	uint64_t dataOffset;
+	uint64_t dataEnd;
+} captureHeader_t;
+
+// Capture index entry: timestamp relative to the first record, position in the data area .
+typedef struct
+{
+	int64_t  deltaNs;
+	uint64_t offset;
+	uint32_t length;
+	uint32_t reserved;
+} captureIndex_t;
+
+// Open capture file .
+typedef struct
+{
+	int               fd;
+	size_t            mapSize;
+	captureHeader_t * header;
+	captureIndex_t  * index;
+	unsigned char   * data;
+} capture_t;
+
+// Local variables .
+static int childPid = 0;
+static int peerPid = 0;
+static int ipcShmid = -1;
+static int ipcSemid = -1;
+static unsigned int blockedCount = 0;
+static unsigned int stallCount = 0;
+static long long waitMaxNs = 0;
+
+// Callback linked to SIGINT signal .
+void endProcessesSignaller (int sig_num)
+{
+	if (childPid == 0)
+	{
+		// Child kill request .
+		printf("Child kill request (pid %d)\n", (int) getpid());
+		printf("Child killing...\n");
+		kill(getpid(), SIGUSR1);
+	}
+	else
+	{
+		// Father kill request: also the child is killed .
+		printf("Father kill request (pid %d)\n", (int) getpid());
+		printf("Child killing...\n");
+		kill(childPid, SIGUSR1);
+		printf("Father killing...\n");
+		kill(getpid(), SIGUSR1);
+	}
+}
+
+// Monotonic time in nanoseconds .
+static long long timeNowNs (void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (long long) ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+// Sleep until an absolute monotonic time .
+static void sleepUntilNs (long long wakeNs)
+{
+	struct timespec ts;
+
+	ts.tv_sec = wakeNs / NSEC_PER_SEC;
+	ts.tv_nsec = wakeNs % NSEC_PER_SEC;
+
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+	{
+	}
+}
+
+// Capture file creation: header, fixed size index and data area mapped in memory .
+static bool captureCreate (capture_t * cap, const char * path)
+{
+	cap->mapSize = sizeof(captureHeader_t) + INDEX_CAPACITY * sizeof(captureIndex_t) + DATA_CAPACITY;
+	cap->fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+	if ((cap->fd < 0) || (ftruncate(cap->fd, (off_t) cap->mapSize) == -1))
+	{
+		printf("capture: %s creation error (%d)\n", path, errno);
+		return false;
+	}
+
+	cap->header = (captureHeader_t *) mmap(NULL, cap->mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, cap->fd, 0);
+
+	if (cap->header == MAP_FAILED)
+	{
+		printf("capture: %s mapping error (%d)\n", path, errno);
+		close(cap->fd);
+		return false;
+	}
+
+	cap->header->magic = CAPTURE_MAGIC;
+	cap->header->version = CAPTURE_VERSION;
+	cap->header->headerSize = sizeof(captureHeader_t);
+	cap->header->recordCount = 0;
+	cap->header->indexOffset = sizeof(captureHeader_t);
+	cap->header->dataOffset = sizeof(captureHeader_t) + INDEX_CAPACITY * sizeof(captureIndex_t);
+	cap->header->dataEnd = 0;
+
+	cap->index = (captureIndex_t *) ((char *) cap->header + cap->header->indexOffset);
+	cap->data = (unsigned char *) cap->header + cap->header->dataOffset;
+
+	return true;
+}
+
+// Capture file opening for replay .
+static bool captureOpen (capture_t * cap, const char * path)
+{
+	struct stat st;
+	const captureHeader_t * header;
+	uint64_t indexEnd;
+
+	cap->fd = open(path, O_RDONLY);
+
+	if ((cap->fd < 0) || (fstat(cap->fd, &st) == -1) || ((size_t) st.st_size < sizeof(captureHeader_t)))
+	{
+		printf("capture: %s opening error (%d)\n", path, errno);
+		return false;
+	}
+
+	cap->mapSize = (size_t) st.st_size;
+	cap->header = (captureHeader_t *) mmap(NULL, cap->mapSize, PROT_READ, MAP_SHARED, cap->fd, 0);
+
+	if (cap->header == MAP_FAILED)
+	{
+		printf("capture: %s mapping error (%d)\n", path, errno);
+		close(cap->fd);
+		return false;
+	}
+
+	// Header geometry checked against the mapping: every bound is a subtraction, no sum can wrap .
+	header = cap->header;
+	indexEnd = header->indexOffset + header->recordCount * sizeof(captureIndex_t);
+
+	if ((header->magic != CAPTURE_MAGIC) || (header->version != CAPTURE_VERSION) ||
+	    (header->headerSize != sizeof(captureHeader_t)) ||
+	    (header->indexOffset != header->headerSize) ||
+	    (header->recordCount > INDEX_CAPACITY) ||
+	    (header->recordCount * sizeof(captureIndex_t) > cap->mapSize - header->indexOffset) ||
+	    (header->dataOffset < indexEnd) || (header->dataOffset > cap->mapSize) ||
+	    (header->dataEnd > cap->mapSize - header->dataOffset))
+	{
+		printf("capture: %s is not a valid capture file\n", path);
+		munmap(cap->header, cap->mapSize);
+		close(cap->fd);
+		return false;
+	}
+
+	cap->index = (captureIndex_t *) ((char *) cap->header + cap->header->indexOffset);
+	cap->data = (unsigned char *) cap->header + cap->header->dataOffset;
+
+	// Sequential access: the kernel can read ahead .
+	madvise(cap->header, cap->mapSize, MADV_SEQUENTIAL);
+
+	return true;
+}
+
+// Record append (false when the index or the data area is full) .
+static bool captureAppend (capture_t * cap, const message_t * msg, long long firstNs)
+{
+	captureHeader_t * header = cap->header;
+	captureIndex_t * entry;
+
+	if ((header->recordCount >= INDEX_CAPACITY) || (header->dataEnd + (uint64_t) msg->length > DATA_CAPACITY))
+	{
+		return false;
+	}
+
+	memcpy(cap->data + header->dataEnd, msg->data, (size_t) msg->length);
+
+	entry = &cap->index[header->recordCount];
+	entry->deltaNs = msg->timeNs - firstNs;
+	entry->offset = header->dataEnd;
+	entry->length = (uint32_t) msg->length;
+	entry->reserved = 0;
+
+	header->dataEnd += (uint64_t) msg->length;
+	header->recordCount++;
+
+	return true;
+}
+
+// Capture file closing: the unused tail of the data area is cut away .
+static void captureClose (capture_t * cap, bool writable)
+{
+	off_t fileSize = (off_t) (cap->header->dataOffset + cap->header->dataEnd);
+
+	if (writable)
+	{
+		msync(cap->header, cap->mapSize, MS_SYNC);
+	}
+
+	munmap(cap->header, cap->mapSize);
+
+	if (writable && (ftruncate(cap->fd, fileSize) == -1))
+	{
+		printf("capture: file truncation error (%d)\n", errno);
+	}
+
+	close(cap->fd);
+}
+
+// Memory creation .
+static int sharedMemCreation (key_t key)
+{
+	struct shmid_ds shmds;
+
+	int shmid = shmget(key, sizeof(channel_t), 0666 | IPC_CREAT);
+
+	if (shmid >= 0)
+	{
+		// Info request .
+		if (shmctl(shmid, IPC_STAT, &shmds) == 0)
+		{
+			printf("%d bytes size shared memory created\n", (int) shmds.shm_segsz);
+		}
+		else
+		{
+			printf("shmctl error = %d\n", errno);
+		}
+	}
+	else
+	{
+		printf("PARENT: shared memory segment not found.\n");
+		exit(-1);
+	}
+
+	return shmid;
+}
+
+// Memory context attaching .
+static bool sharedMemAttach (int shmid, int role, channel_t * * ptPtMem)
+{
+	struct shmid_ds shmds;
+	bool success = true;
+
+	// Attach shmid memory .
+	*ptPtMem = (channel_t *) shmat(shmid, (const void *)0, 0);
+
+	// Info request .
+	if ((*ptPtMem != (channel_t *) -1) && (shmctl(shmid, IPC_STAT, &shmds) == 0))
+	{
+		printf("%s: context attached (currently %d attaches)\n", ((role == 0) ? "PARENT" : " CHILD"), (int) shmds.shm_nattch);
+	}
+	else
+	{
+		printf("%s: shmctl error = %d\n",((role == 0) ? "PARENT" : " CHILD"), errno);
+		success = false;
+	}
+
+	return success;
+}
+
+// Memory context detaching .
+static void sharedMemDetaches(channel_t * ptMem, int shmid, int role)
+{
+	struct shmid_ds shmds;
+
+	if (shmdt(ptMem) == -1)
+	{
+		printf("%s: memory detaching error(%d)\n", ((role == 0) ? "PARENT" : " CHILD"), errno);
+	}
+	else
+	{
+		// Update info .
+		if(shmctl(shmid, IPC_STAT, &shmds) == 0)
+		{
+			printf("%s: memory (created by pid %d) detached (currently remaining %d attached)\n", ((role == 0) ? "PARENT" : " CHILD"), (int) shmds.shm_cpid, (int) shmds.shm_nattch);
+		}
+		else
+		{
+			printf("%s: shmctl error=%d\n", ((role == 0) ? "PARENT" : " CHILD"), errno);
+		}
+	}
+}
+
+// Channel semaphores creation: EMPTY counts free slots, FULL counts ready messages .
+static int semCreate (key_t key)
+{
+	int semid;
+
+	semid = semget(key, 2, 0666 | IPC_CREAT );
+
+	if (semid != -1)
+	{
+		if ((semctl(semid, SEM_EMPTY, SETVAL, CHANNEL_SLOTS) == -1) || (semctl(semid, SEM_FULL, SETVAL, 0) == -1))
+		{
+			semctl(semid, 0, IPC_RMID);
+			return -1;
+		}
+
+		printf( "Semaphore set %d has been created\n", semid);
+	}
+
+	return semid;
+}
+
+// Semaphore set removing .
+static void semDelete (int semid)
+{
+	int res = semctl(semid, 0, IPC_RMID);
+
+	if (res != -1)
+	{
+		printf("Semaphore set %d removed.\n", semid);
+	}
+}
+
+// Give-up path: the peer is dead, so nobody else will remove the IPC objects (the next run would find them) .
+static void ipcGiveUp (int role)
+{
+	if ((ipcShmid != -1) && (shmctl(ipcShmid, IPC_RMID, 0) == 0))
+	{
+		printf("%s: memory segment removed\n", ((role == 0) ? "PARENT" : " CHILD"));
+	}
+
+	if (ipcSemid != -1)
+	{
+		semDelete(ipcSemid);
+	}
+
+	exit(-1);
+}
+
+// Blocked decrement: bounded waits, every threshold spent blocked is reported with the holder (the peer) pid .
+static void semBoundedWait (int semid, int semNum, int op, int role)
+{
+	struct sembuf sb;
+	struct timespec timeout;
+	long long start, waitedNs;
+
+	sb.sem_num = semNum;
+	sb.sem_op = op;
+	sb.sem_flg = 0;
+
+	timeout.tv_sec = (STALL_THRESHOLD_MS * NSEC_PER_MS) / NSEC_PER_SEC;
+	timeout.tv_nsec = (STALL_THRESHOLD_MS * NSEC_PER_MS) % NSEC_PER_SEC;
+
+	start = timeNowNs();
+
+	while ( semtimedop(semid, &sb, 1, &timeout) == -1 )
+	{
+		if (errno == EAGAIN)
+		{
+			printf("%s: semaphore %d.%d stalled for %lld ms (holder pid %d)\n", ((role == 0) ? "PARENT" : " CHILD"), semid, semNum, (timeNowNs() - start) / NSEC_PER_MS, peerPid);
+
+			// A dead peer (or an own child already exited) will never post .
+			if ((peerPid > 0) && (((kill(peerPid, 0) == -1) && (errno == ESRCH)) || (waitpid(peerPid, NULL, WNOHANG) == peerPid)))
+			{
+				printf("%s: semaphore %d.%d holder (pid %d) is dead.\n", ((role == 0) ? "PARENT" : " CHILD"), semid, semNum, peerPid);
+				ipcGiveUp(role);
+			}
+		}
+		else if (errno != EINTR)
+		{
+			printf("%s: semaphore %d.%d operation failed.\n", ((role == 0) ? "PARENT" : " CHILD"), semid, semNum);
+			exit(-1);
+		}
+	}
+
+	// Wait statistics (blocked waits only) .
+	waitedNs = timeNowNs() - start;
+	blockedCount++;
+
+	if (waitedNs > waitMaxNs)
+	{
+		waitMaxNs = waitedNs;
+	}
+
+	if (waitedNs >= STALL_THRESHOLD_MS * NSEC_PER_MS)
+	{
+		stallCount++;
+		printf("%s: semaphore %d.%d wait took %lld ms (threshold %d ms)\n", ((role == 0) ? "PARENT" : " CHILD"), semid, semNum, waitedNs / NSEC_PER_MS, STALL_THRESHOLD_MS);
+	}
+}
+
+// Semaphore operation on one semaphore of the set: a decrement that would block becomes a bounded wait .
+static void semOperation (int semid, int semNum, int op, int role)
+{
+	struct sembuf sb;
+
+	sb.sem_num = semNum;
+	sb.sem_op = op;
+	sb.sem_flg = (op < 0) ? IPC_NOWAIT : 0;
+
+	while ( semop(semid, &sb, 1) == -1 )
+	{
+		if (errno == EAGAIN)
+		{
+			semBoundedWait(semid, semNum, op, role);
+			break;
+		}
+
+		if (errno != EINTR)
+		{
+			printf("%s: semaphore %d.%d operation failed.\n", ((role == 0) ? "PARENT" : " CHILD"), semid, semNum);
+			exit(-1);
+		}
+	}
+}
+
+// Channel publish .
+static void channelSend (channel_t * ch, int semid, const message_t * msg, int role)
+{
+	message_t * slot;
+
+	semOperation(semid, SEM_EMPTY, -1, role);
+
+	// Only the used part of the payload is copied .
+	slot = &ch->slot[ch->head % CHANNEL_SLOTS];
+	slot->seq = msg->seq;
+	slot->timeNs = msg->timeNs;
+	slot->length = msg->length;
+	memcpy(slot->data, msg->data, (size_t) msg->length);
+	ch->head++;
+
+	semOperation(semid, SEM_FULL, 1, role);
+}
+
+// Channel receive .
+static void channelReceive (channel_t * ch, int semid, message_t * msg, int role)
+{
+	message_t * slot;
+
+	semOperation(semid, SEM_FULL, -1, role);
+
+	slot = &ch->slot[ch->tail % CHANNEL_SLOTS];
+	msg->seq = slot->seq;
+	msg->timeNs = slot->timeNs;
+	msg->length = slot->length;
+	memcpy(msg->data, slot->data, (size_t) slot->length);
+	ch->tail++;
+
+	semOperation(semid, SEM_EMPTY, 1, role);
+}
+
+// Live producer: variable length messages in bursts .
+static void producerRun (channel_t * ch, int semid, int role)
+{
+	message_t msg;
+	long long seq;
+	int k;
+
+	for (seq=0; seq < MESSAGE_NUMBER; seq++)
+	{
+		msg.seq = seq;
+		msg.length = MSG_MIN + (int) (seq % (MSG_MAX - MSG_MIN + 1));
+
+		for (k=0; k < msg.length; k++)
+		{
+			msg.data[k] = (unsigned char) (seq + k);
+		}
+
+		msg.timeNs = timeNowNs();
+		channelSend(ch, semid, &msg, role);
+
+		if ((seq % BURST_MESSAGES) == BURST_MESSAGES - 1)
+		{
+			usleep(USLEEP_BURST_MS);
+		}
+	}
+
+	msg.seq = END_OF_STREAM;
+	msg.length = 0;
+	msg.timeNs = timeNowNs();
+	channelSend(ch, semid, &msg, role);
+}
+
+// Recorder: the channel is drained into the capture file .
+static void recorderRun (channel_t * ch, int semid, const char * path, int role)
+{
+	capture_t cap;
+	message_t msg;
+	long long firstNs = 0, dropped = 0;
+
+	if (!captureCreate(&cap, path))
+	{
+		return;
+	}
+
+	for (;;)
+	{
+		channelReceive(ch, semid, &msg, role);
+
+		if (msg.seq == END_OF_STREAM)
+		{
+			break;
+		}
+
+		if (cap.header->recordCount == 0)
+		{
+			firstNs = msg.timeNs;
+		}
+
+		if (!captureAppend(&cap, &msg, firstNs))
+		{
+			dropped++;
+		}
+	}
+
+	printf(" CHILD: %llu records (%llu data bytes) captured in %s, %lld dropped (capture full)\n",
+	       (unsigned long long) cap.header->recordCount, (unsigned long long) cap.header->dataEnd, path, dropped);
+
+	captureClose(&cap, true);
+}
+
+// Replayer: the capture file is fed back into the channel .
+static void replayerRun (channel_t * ch, int semid, const char * path, bool timed, int role)
+{
+	capture_t cap;
+	message_t msg;
+	captureIndex_t * entry;
+	long long startNs;
+	uint64_t i;
+
+	if (!captureOpen(&cap, path))
+	{
+		msg.seq = END_OF_STREAM;
+		msg.length = 0;
+		channelSend(ch, semid, &msg, role);
+		return;
+	}
+
+	printf("PARENT: replaying %llu records from %s (%s)\n", (unsigned long long) cap.header->recordCount, path, timed ? "original timing" : "full speed");
+
+	startNs = timeNowNs();
+
+	for (i=0; i < cap.header->recordCount; i++)
+	{
+		entry = &cap.index[i];
+
+		// Corrupted entry: the replay stops .
+		if ((entry->length > MSG_MAX) || (entry->offset > cap.header->dataEnd) || (entry->length > cap.header->dataEnd - entry->offset))
+		{
+			printf("PARENT: invalid record %llu, replay stopped\n", (unsigned long long) i);
+			break;
+		}
+
+		if (timed)
+		{
+			sleepUntilNs(startNs + entry->deltaNs);
+		}
+
+		msg.seq = (long long) i;
+		msg.length = (int) entry->length;
+		memcpy(msg.data, cap.data + entry->offset, entry->length);
+		msg.timeNs = timeNowNs();
+
+		channelSend(ch, semid, &msg, role);
+	}
+
+	msg.seq = END_OF_STREAM;
+	msg.length = 0;
+	channelSend(ch, semid, &msg, role);
+
+	captureClose(&cap, false);
+}
+
+// Consumer: payload check and throughput .
+static void consumerRun (channel_t * ch, int semid, int role)
+{
+	message_t msg;
+	long long count = 0, bytes = 0, errors = 0, start = 0, elapsed;
+	int k;
+
+	for (;;)
+	{
+		channelReceive(ch, semid, &msg, role);
+
+		if (count == 0)
+		{
+			start = timeNowNs();
+		}
+
+		if (msg.seq == END_OF_STREAM)
+		{
+			break;
+		}
+
+		// The consumer knows the payload pattern .
+		for (k=0; k < msg.length; k++)
+		{
+			if (msg.data[k] != (unsigned char) (msg.seq + k))
+			{
+				errors++;
+				break;
+			}
+		}
+
+		count++;
+		bytes += msg.length;
+	}
+
+	elapsed = timeNowNs() - start;
+
+	if (elapsed > 0)
+	{
+		printf(" CHILD: %lld messages, %lld bytes in %lld ms: %.0f msg/s, %.1f MB/s, %lld payload errors\n",
+		       count, bytes, elapsed / 1000000, (double) count * NSEC_PER_SEC / (double) elapsed, (double) bytes * 1000.0 / (double) elapsed, errors);
+	}
+}
+
+// Main routine: usage SharedMemoryCaptureReplay record <file> | replay <file> [timed] .
+int main(int argc, char * argv[])
+{
+	int shmid, semid, retFork, status;
+	channel_t * ch = NULL;
+	int role = -1;
+	bool record, timed;
+
+	if ((argc < 3) || ((strcmp(argv[1], "record") != 0) && (strcmp(argv[1], "replay") != 0)))
+	{
+		printf("Usage: %s record <file> | replay <file> [timed]\n", argv[0]);
+		return -1;
+	}
+
+	record = (strcmp(argv[1], "record") == 0);
+	timed = (argc > 3) && (strcmp(argv[3], "timed") == 0);
+
+	// Signal callback registration .
+	signal(SIGINT, endProcessesSignaller);
+
+	// Shared memory create .
+	shmid = sharedMemCreation(SHARED_MEM_ID);
+
+	// Channel semaphores create .
+	semid = semCreate(SEM_ID);
+
+	if (semid < 0)
+	{
+		printf("Semaphore creation error\n");
+		exit(-1);
+	}
+
+	ipcShmid = shmid;
+	ipcSemid = semid;
+
+	// Child creation .
+	fflush(stdout);
+	retFork = fork();
+
+	// Child pid update .
+	if (retFork > 0)
+	{
+		childPid = retFork;
+		peerPid = retFork;
+	}
+	else if (retFork == 0)
+	{
+		peerPid = getppid();
+	}
+
+	// Father: live producer or replayer .
+	if (retFork > 0)
+	{
+		printf("PARENT: process created (pid %d)\n", (int) getpid());
+
+		role = 0;
+
+		// Keep the context .
+		if ( sharedMemAttach(shmid, role, &ch) )
+		{
+			if (record)
+			{
+				producerRun(ch, semid, role);
+			}
+			else
+			{
+				replayerRun(ch, semid, argv[2], timed, role);
+			}
+		}
+
+		// Wait child ending before delete memory .
+		retFork = wait(&status);
+
+		// Detaching memory .
+		sharedMemDetaches(ch, shmid, role);
+
+		// Removing memory .
+		if (shmctl( shmid, IPC_RMID, 0 ) == 0)
+		{
+			printf( "PARENT: memory segment removed\n");
+		}
+		else
+		{
+			printf( "PARENT: memory segment removing fail!\n" );
+		}
+
+		// Semaphores delete .
+		semDelete(semid);
+	}
+	else if (retFork == 0)
+	{
+		// Child: recorder or consumer .
+		role = 1;
+
+		printf(" CHILD: child process created (pid %d)\n", (int) getpid());
+
+		// Keep identifier of the shared memory segment .
+		shmid = shmget(SHARED_MEM_ID, 0, 0);
+
+		// Keep the context .
+		if ( sharedMemAttach(shmid, role, &ch) )
+		{
+			if (record)
+			{
+				recorderRun(ch, semid, argv[2], role);
+			}
+			else
+			{
+				consumerRun(ch, semid, role);
+			}
+
+			// Memory detach .
+			sharedMemDetaches(ch, shmid, role);
+		}
+	}
+	else
+	{
+		printf("CHILD: error trying to fork() (%d)\n", errno);
+	}
+
+	printf("%s: %u blocked semaphore waits, max %lld us, %u over %d ms\n", ((role == 0) ? "PARENT" : " CHILD"), blockedCount, waitMaxNs / 1000, stallCount, STALL_THRESHOLD_MS);
+	printf("%s: Exiting...\n", ((role == 0) ? "PARENT" : " CHILD"));
+	fflush(stdout);
+
+	return 0;
+}
@@ -0,0 +1,570 @@
+/* ============================================================================ **
+ **                           Embedded Linux                                     **
+ ** ============================================================================ **
+ **             +++++++++++++++++++++++++++++++++++++++++++                      **
+ **    Module:  +    SharedMemoryChannel.hpp              +                      **
+ **             +++++++++++++++++++++++++++++++++++++++++++                      **
+ **                                                                              **
+ **  Description: Header only C++ typed channel on a shared memory segment:      **
+ **               payload type, capacity and synchronization policy are template **
+ **               parameters, so geometry and masks are compile time constants   **
+ **               and the hot loop has no modulo and no backend branch           **
+ **                                                                              **
+ ** ============================================================================ **
+ **         Edit                                      Data           Author      **
+ **    First release                                18/10/2026     F.Coppo       **
+ ** ============================================================================ */
+
+#ifndef SHARED_MEMORY_CHANNEL_HPP
+#define SHARED_MEMORY_CHANNEL_HPP
+
+// Include .
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cerrno>
+#include <csignal>
+#include <ctime>
+#include <atomic>
+#include <new>
+#include <type_traits>
+#include <sys/types.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <sys/sem.h>
+#include <sys/wait.h>
+#include <pthread.h>
+#include <sched.h>
+
+namespace shm
+{
+
+// Define .
+constexpr std::size_t CACHE_LINE = 64;
+constexpr long long   NSEC_PER_SEC = 1000000000LL;
+constexpr long long   STALL_THRESHOLD_NS = 500LL * 1000000LL;
+
+// Bounded wait outcome: on a timeout the channel reports the stall and checks its peer .
+enum WaitResult
+{
+	WAIT_DONE = 0,
+	WAIT_TIMEOUT,
+	WAIT_ERROR
+};
+
+// Monotonic time in nanoseconds .
+inline long long timeNowNs ()
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (long long) ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+// Unix system V semaphores: one set with free slots and ready messages counts .
+struct SysVSync
+{
+	static constexpr const char * name = "SYSV";
+
+	// Semaphore set id lives in the segment, so an attaching process finds it .
+	struct Shared
+	{
+		int semid;
+	};
+
+	enum
+	{
+		SEM_EMPTY = 0,
+		SEM_FULL
+	};
+
+	static bool create (Shared & sh, key_t key, unsigned int capacity)
+	{
+		sh.semid = semget(key, 2, 0666 | IPC_CREAT);
+
+		return (sh.semid != -1) && (semctl(sh.semid, SEM_EMPTY, SETVAL, capacity) != -1) && (semctl(sh.semid, SEM_FULL, SETVAL, 0) != -1);
+	}
+
+	static void destroy (Shared & sh)
+	{
+		semctl(sh.semid, 0, IPC_RMID);
+	}
+
+	static bool operation (const Shared & sh, unsigned short num, short op)
+	{
+		struct sembuf sb;
+
+		sb.sem_num = num;
+		sb.sem_op = op;
+		sb.sem_flg = 0;
+
+		return semop(sh.semid, &sb, 1) != -1;
+	}
+
+	// Decrement bounded to one stall threshold (the free semaphore costs one semop, as an unbounded wait) .
+	static WaitResult boundedDecrement (const Shared & sh, unsigned short num)
+	{
+		struct sembuf sb;
+		struct timespec timeout;
+
+		sb.sem_num = num;
+		sb.sem_op = -1;
+		sb.sem_flg = IPC_NOWAIT;
+
+		if (semop(sh.semid, &sb, 1) != -1)
+		{
+			return WAIT_DONE;
+		}
+
+		if (errno != EAGAIN)
+		{
+			return WAIT_ERROR;
+		}
+
+		sb.sem_flg = 0;
+		timeout.tv_sec = STALL_THRESHOLD_NS / NSEC_PER_SEC;
+		timeout.tv_nsec = STALL_THRESHOLD_NS % NSEC_PER_SEC;
+
+		while (semtimedop(sh.semid, &sb, 1, &timeout) == -1)
+		{
+			if (errno == EAGAIN)
+			{
+				return WAIT_TIMEOUT;
+			}
+
+			if (errno != EINTR)
+			{
+				return WAIT_ERROR;
+			}
+		}
+
+		return WAIT_DONE;
+	}
+
+	static WaitResult waitSlot (Shared & sh, std::uint32_t, unsigned int)  { return boundedDecrement(sh, SEM_EMPTY); }
+	static bool       postData (Shared & sh, std::uint32_t)                { return operation(sh, SEM_FULL, 1); }
+	static WaitResult waitData (Shared & sh, std::uint32_t)                { return boundedDecrement(sh, SEM_FULL); }
+	static bool       postSlot (Shared & sh, std::uint32_t)                { return operation(sh, SEM_EMPTY, 1); }
+};
+
+// Process shared (robust) pthread mutex and condition variables inside the segment .
+struct PthreadSync
+{
+	static constexpr const char * name = "PTHREAD";
+
+	struct Shared
+	{
+		pthread_mutex_t mutex;
+		pthread_cond_t  notFull;
+		pthread_cond_t  notEmpty;
+		unsigned int    free;
+		unsigned int    ready;
+	};
+
+	static bool create (Shared & sh, key_t, unsigned int capacity)
+	{
+		pthread_mutexattr_t mutexAttr;
+		pthread_condattr_t condAttr;
+		bool success;
+
+		pthread_mutexattr_init(&mutexAttr);
+		pthread_mutexattr_setpshared(&mutexAttr, PTHREAD_PROCESS_SHARED);
+		pthread_mutexattr_setrobust(&mutexAttr, PTHREAD_MUTEX_ROBUST);
+
+		pthread_condattr_init(&condAttr);
+		pthread_condattr_setpshared(&condAttr, PTHREAD_PROCESS_SHARED);
+		pthread_condattr_setclock(&condAttr, CLOCK_MONOTONIC);
+
+		success = (pthread_mutex_init(&sh.mutex, &mutexAttr) == 0) &&
+		          (pthread_cond_init(&sh.notFull, &condAttr) == 0) &&
+		          (pthread_cond_init(&sh.notEmpty, &condAttr) == 0);
+
+		sh.free = capacity;
+		sh.ready = 0;
+
+		pthread_condattr_destroy(&condAttr);
+		pthread_mutexattr_destroy(&mutexAttr);
+
+		return success;
+	}
+
+	static void destroy (Shared & sh)
+	{
+		pthread_cond_destroy(&sh.notEmpty);
+		pthread_cond_destroy(&sh.notFull);
+		pthread_mutex_destroy(&sh.mutex);
+	}
+
+	// Robust lock: a mutex left locked by a dead process is recovered .
+	static bool lock (Shared & sh)
+	{
+		int res = pthread_mutex_lock(&sh.mutex);
+
+		if (res == EOWNERDEAD)
+		{
+			res = pthread_mutex_consistent(&sh.mutex);
+		}
+
+		return res == 0;
+	}
+
+	// Count decrement, blocking while zero for one stall threshold at most (monotonic condition clock) .
+	static WaitResult take (Shared & sh, unsigned int & count, pthread_cond_t & cond)
+	{
+		struct timespec deadline;
+		long long deadlineNs;
+		int res;
+
+		if (!lock(sh))
+		{
+			return WAIT_ERROR;
+		}
+
+		if (count == 0)
+		{
+			deadlineNs = timeNowNs() + STALL_THRESHOLD_NS;
+			deadline.tv_sec = deadlineNs / NSEC_PER_SEC;
+			deadline.tv_nsec = deadlineNs % NSEC_PER_SEC;
+
+			while (count == 0)
+			{
+				res = pthread_cond_timedwait(&cond, &sh.mutex, &deadline);
+
+				if (res == EOWNERDEAD)
+				{
+					pthread_mutex_consistent(&sh.mutex);
+				}
+				else if ((res == ETIMEDOUT) && (count == 0))
+				{
+					pthread_mutex_unlock(&sh.mutex);
+					return WAIT_TIMEOUT;
+				}
+			}
+		}
+
+		count--;
+
+		return (pthread_mutex_unlock(&sh.mutex) == 0) ? WAIT_DONE : WAIT_ERROR;
+	}
+
+	// Count increment, wake up the waiter .
+	static bool give (Shared & sh, unsigned int & count, pthread_cond_t & cond)
+	{
+		if (!lock(sh))
+		{
+			return false;
+		}
+
+		count++;
+		pthread_cond_signal(&cond);
+
+		return pthread_mutex_unlock(&sh.mutex) == 0;
+	}
+
+	static WaitResult waitSlot (Shared & sh, std::uint32_t, unsigned int)  { return take(sh, sh.free, sh.notFull); }
+	static bool       postData (Shared & sh, std::uint32_t)                { return give(sh, sh.ready, sh.notEmpty); }
+	static WaitResult waitData (Shared & sh, std::uint32_t)                { return take(sh, sh.ready, sh.notEmpty); }
+	static bool       postSlot (Shared & sh, std::uint32_t)                { return give(sh, sh.free, sh.notFull); }
+};
+
+// Lock-free single producer/single consumer: published indexes on separate cache lines .
+struct SpinSync
+{
+	static constexpr const char * name = "SPIN";
+
+	static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "cross process atomics must be lock-free");
+
+	struct Shared
+	{
+		alignas(CACHE_LINE) std::atomic<std::uint32_t> head;
+		alignas(CACHE_LINE) std::atomic<std::uint32_t> tail;
+	};
+
+	static bool create (Shared & sh, key_t, unsigned int)
+	{
+		sh.head.store(0, std::memory_order_relaxed);
+		sh.tail.store(0, std::memory_order_relaxed);
+
+		return true;
+	}
+
+	static void destroy (Shared &)
+	{
+	}
+
+	// Clock read once every SPIN_CHECK yields: the bound costs nothing while the index moves .
+	static constexpr unsigned int SPIN_CHECK = 1024;
+
+	// Busy wait yields the CPU (producer and consumer may share one core), bounded to one stall threshold .
+	static WaitResult waitSlot (Shared & sh, std::uint32_t index, unsigned int capacity)
+	{
+		long long deadlineNs = 0;
+		unsigned int spins = 0;
+
+		while ((std::uint32_t) (index - sh.tail.load(std::memory_order_acquire)) >= capacity)
+		{
+			if ((++spins % SPIN_CHECK) == 0)
+			{
+				if (deadlineNs == 0)
+				{
+					deadlineNs = timeNowNs() + STALL_THRESHOLD_NS;
+				}
+				else if (timeNowNs() >= deadlineNs)
+				{
+					return WAIT_TIMEOUT;
+				}
+			}
+
+			sched_yield();
+		}
+
+		return WAIT_DONE;
+	}
+
+	static bool postData (Shared & sh, std::uint32_t index)
+	{
+		sh.head.store(index + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	static WaitResult waitData (Shared & sh, std::uint32_t index)
+	{
+		long long deadlineNs = 0;
+		unsigned int spins = 0;
+
+		while (sh.head.load(std::memory_order_acquire) == index)
+		{
+			if ((++spins % SPIN_CHECK) == 0)
+			{
+				if (deadlineNs == 0)
+				{
+					deadlineNs = timeNowNs() + STALL_THRESHOLD_NS;
+				}
+				else if (timeNowNs() >= deadlineNs)
+				{
+					return WAIT_TIMEOUT;
+				}
+			}
+
+			sched_yield();
+		}
+
+		return WAIT_DONE;
+	}
+
+	static bool postSlot (Shared & sh, std::uint32_t index)
+	{
+		sh.tail.store(index + 1, std::memory_order_release);
+
+		return true;
+	}
+};
+
+// Single producer/single consumer typed channel: each endpoint keeps its own free running index .
+template <typename T, std::size_t Capacity, typename SyncPolicy>
+class Channel
+{
+	static_assert(std::is_trivially_copyable<T>::value, "channel payload must be trivially copyable (it is copied byte-wise between processes)");
+	static_assert((Capacity > 0) && ((Capacity & (Capacity - 1)) == 0), "channel capacity must be a power of two");
+	static_assert(Capacity <= 0x80000000u, "channel capacity exceeds the 32 bit index range");
+	static_assert(alignof(T) <= CACHE_LINE, "payload alignment exceeds the cache line the slots start on");
+
+public:
+	// Segment layout: synchronization block, then the slots from a fresh cache line .
+	struct Layout
+	{
+		typename SyncPolicy::Shared sync;
+		alignas(CACHE_LINE) T       slot[Capacity];
+	};
+
+	static constexpr std::size_t   capacity = Capacity;
+	static constexpr std::uint32_t mask = (std::uint32_t) (Capacity - 1);
+	static constexpr std::size_t   slotSize = sizeof(T);
+	static constexpr std::size_t   segmentSize = sizeof(Layout);
+
+	// Slot of a free running index (no modulo) .
+	static constexpr std::uint32_t slotIndex (std::uint32_t index)
+	{
+		return index & mask;
+	}
+
+	Channel () : shmid(-1), mem(nullptr), sendIndex(0), receiveIndex(0), peerPid(0)
+	{
+	}
+
+	// Process on the other side (checked when a wait stalls: a dead peer makes send/receive fail) .
+	void peer (pid_t pid)
+	{
+		peerPid = pid;
+	}
+
+	// Segment creation, attach and synchronization setup (semKey is used by the System V policy only) .
+	bool create (key_t shmKey, key_t semKey)
+	{
+		shmid = shmget(shmKey, segmentSize, 0666 | IPC_CREAT);
+
+		if ((shmid == -1) || !attachId())
+		{
+			std::printf("Channel: segment %d creation error (%d)\n", (int) shmKey, errno);
+			return false;
+		}
+
+		// Zeroed layout, then the policy initializes its own block .
+		new (mem) Layout();
+
+		if (!SyncPolicy::create(mem->sync, semKey, Capacity))
+		{
+			std::printf("Channel: %s synchronization creation error (%d)\n", SyncPolicy::name, errno);
+			return false;
+		}
+
+		std::printf("Channel: %d slots of %d bytes, %d bytes segment, %s synchronization\n", (int) Capacity, (int) slotSize, (int) segmentSize, SyncPolicy::name);
+
+		return true;
+	}
+
+	// Attach to a channel created by another process (same template arguments) .
+	bool attach (key_t shmKey)
+	{
+		shmid = shmget(shmKey, segmentSize, 0666);
+
+		return (shmid != -1) && attachId();
+	}
+
+	// Memory context detaching .
+	void detach ()
+	{
+		if (mem != nullptr)
+		{
+			shmdt(mem);
+			mem = nullptr;
+		}
+	}
+
+	// Synchronization and segment removing (creator only, once both sides are done) .
+	void remove ()
+	{
+		if (mem != nullptr)
+		{
+			SyncPolicy::destroy(mem->sync);
+		}
+
+		detach();
+
+		if (shmid != -1)
+		{
+			shmctl(shmid, IPC_RMID, 0);
+			shmid = -1;
+		}
+	}
+
+	// Blocking send: wait one free slot, copy, publish .
+	bool send (const T & msg)
+	{
+		WaitResult res;
+		int stalls = 0;
+
+		while ((res = SyncPolicy::waitSlot(mem->sync, sendIndex, Capacity)) == WAIT_TIMEOUT)
+		{
+			if (!stalled("send", ++stalls))
+			{
+				return false;
+			}
+		}
+
+		if (res != WAIT_DONE)
+		{
+			return false;
+		}
+
+		mem->slot[slotIndex(sendIndex)] = msg;
+
+		if (!SyncPolicy::postData(mem->sync, sendIndex))
+		{
+			return false;
+		}
+
+		sendIndex++;
+
+		return true;
+	}
+
+	// Blocking receive: wait one message, copy, give the slot back .
+	bool receive (T & msg)
+	{
+		WaitResult res;
+		int stalls = 0;
+
+		while ((res = SyncPolicy::waitData(mem->sync, receiveIndex)) == WAIT_TIMEOUT)
+		{
+			if (!stalled("receive", ++stalls))
+			{
+				return false;
+			}
+		}
+
+		if (res != WAIT_DONE)
+		{
+			return false;
+		}
+
+		msg = mem->slot[slotIndex(receiveIndex)];
+
+		if (!SyncPolicy::postSlot(mem->sync, receiveIndex))
+		{
+			return false;
+		}
+
+		receiveIndex++;
+
+		return true;
+	}
+
+	// Typed view of the slots .
+	T * storage ()
+	{
+		return mem->slot;
+	}
+
+private:
+	// Wait still blocked after one more threshold: report, false when the peer is dead (errno ESRCH) .
+	bool stalled (const char * what, int stalls)
+	{
+		std::printf("Channel: %s %s stalled for %lld ms (peer pid %d)\n", SyncPolicy::name, what, stalls * (STALL_THRESHOLD_NS / 1000000), (int) peerPid);
+
+		if ((peerPid > 0) && (((kill(peerPid, 0) == -1) && (errno == ESRCH)) || (waitpid(peerPid, nullptr, WNOHANG) == peerPid)))
+		{
+			std::printf("Channel: peer (pid %d) is dead.\n", (int) peerPid);
+			errno = ESRCH;
+			return false;
+		}
+
+		return true;
+	}
+
+	bool attachId ()
+	{
+		void * addr = shmat(shmid, nullptr, 0);
+
+		if (addr == (void *) -1)
+		{
+			return false;
+		}
+
+		mem = static_cast<Layout *>(addr);
+
+		return true;
+	}
+
+	int           shmid;
+	Layout *      mem;
+	std::uint32_t sendIndex;
+	std::uint32_t receiveIndex;
+	pid_t         peerPid;
+};
+
+}
+
+#endif
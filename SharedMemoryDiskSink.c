@@ -0,0 +1,870 @@
+/* ============================================================================ **
+ **                           Embedded Linux                                     **
+ ** ============================================================================ **
+ **               +++++++++++++++++++++++++++++++++++++++                        **
+ **    Module:    +      SharedMemoryDiskSink.c         +                        **
+ **               +++++++++++++++++++++++++++++++++++++++                        **
+ **                                                                              **
+ **  Description: This module implements a sink stage persisting the messages    **
+ **               of a shared memory channel: ready slots are drained in batches **
+ **               and written by io_uring (registered buffers, raw syscalls),    **
+ **               a slot is given back to the producer only when its write is    **
+ **               complete; blocking pwrite and vmsplice/splice for comparison   **
+ **                                                                              **
+ ** ============================================================================ **
+ **         Edit                                      Data           Author      **
+ **    First release                                18/10/2026     F.Coppo       **
+ ** ============================================================================ */
+
+// Include .
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <sys/shm.h>
+#include <errno.h>
+#include <sys/wait.h>
+#include <stdbool.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <sys/sem.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <linux/io_uring.h>
+
+// Define .
+#define SHARED_MEM_ID          111
+#define SEM_ID                 112
+#define SLOT_SIZE              65536
+#define CHANNEL_SLOTS          32
+#define MESSAGE_NUMBER         2048
+#define BATCH_MAX              16
+#define OFFSET                 65000
+#define NSEC_PER_SEC 1000000000LL
+#define NSEC_PER_MS     1000000LL
+#define STALL_THRESHOLD_MS     500
+
+// Semaphore set indexes .
+#define SEM_EMPTY              0
+#define SEM_FULL               1
+
+// Sink write mode .
+typedef enum
+{
+	SINK_URING = 0,
+	SINK_PWRITE,
+	SINK_SPLICE
+} sinkMode_t;
+
+// Message: one page aligned slot, written to the file as a fixed size record .
+typedef struct
+{
+	long long seq;
+	long long items;
+	long long data[(SLOT_SIZE - 2 * sizeof(long long)) / sizeof(long long)];
+} message_t;
+
+// Shared memory layout: slots only (the segment is page aligned) .
+typedef struct
+{
+	message_t slot[CHANNEL_SLOTS];
+} channel_t;
+
+// io_uring instance: rings mapped from the kernel .
+typedef struct
+{
+	int                   fd;
+	unsigned int          entries;
+	unsigned int *        sqHead;
+	unsigned int *        sqTail;
+	unsigned int *        sqMask;
+	unsigned int *        sqArray;
+	struct io_uring_sqe * sqes;
+	unsigned int *        cqHead;
+	unsigned int *        cqTail;
+	unsigned int *        cqMask;
+	struct io_uring_cqe * cqes;
+	void *                sqRing;
+	void *                cqRing;
+	size_t                sqRingSize;
+	size_t                cqRingSize;
+	bool                  fixed;
+} uring_t;
+
+// Sink statistics .
+typedef struct
+{
+	long long batches;
+	long long maxInFlight;
+	long long writeErrors;
+	long long shortWrites;
+} sinkStats_t;
+
+// Local variables .
+static int childPid = 0;
+static int peerPid = 0;
+static int ipcShmid = -1;
+static int ipcSemid = -1;
+static unsigned int blockedCount = 0;
+static unsigned int stallCount = 0;
+static long long waitMaxNs = 0;
+static const char * modeName[] = { "uring", "pwrite", "splice" };
+
+// Callback linked to SIGINT signal .
+void endProcessesSignaller (int sig_num)
+{
+	if (childPid == 0)
+	{
+		// Child kill request .
+		printf("Child kill request (pid %d)\n", (int) getpid());
+		printf("Child killing...\n");
+		kill(getpid(), SIGUSR1);
+	}
+	else
+	{
+		// Father kill request: also the child is killed .
+		printf("Father kill request (pid %d)\n", (int) getpid());
+		printf("Child killing...\n");
+		kill(childPid, SIGUSR1);
+		printf("Father killing...\n");
+		kill(getpid(), SIGUSR1);
+	}
+}
+
+// Monotonic time in nanoseconds .
+static long long timeNowNs (void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (long long) ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+// Memory creation .
+static int sharedMemCreation (key_t key)
+{
+	struct shmid_ds shmds;
+
+	int shmid = shmget(key, sizeof(channel_t), 0666 | IPC_CREAT);
+
+	if (shmid >= 0)
+	{
+		// Info request .
+		if (shmctl(shmid, IPC_STAT, &shmds) == 0)
+		{
+			printf("%d bytes size shared memory created\n", (int) shmds.shm_segsz);
+		}
+		else
+		{
+			printf("shmctl error = %d\n", errno);
+		}
+	}
+	else
+	{
+		printf("PARENT: shared memory segment not found.\n");
+		exit(-1);
+	}
+
+	return shmid;
+}
+
+// Memory context attaching .
+static bool sharedMemAttach (int shmid, int role, channel_t * * ptPtMem)
+{
+	struct shmid_ds shmds;
+	bool success = true;
+
+	// Attach shmid memory .
+	*ptPtMem = (channel_t *) shmat(shmid, (const void *)0, 0);
+
+	// Info request .
+	if ((*ptPtMem != (channel_t *) -1) && (shmctl(shmid, IPC_STAT, &shmds) == 0))
+	{
+		printf("%s: context attached (currently %d attaches)\n", ((role == 0) ? "PARENT" : " CHILD"), (int) shmds.shm_nattch);
+	}
+	else
+	{
+		printf("%s: shmctl error = %d\n",((role == 0) ? "PARENT" : " CHILD"), errno);
+		success = false;
+	}
+
+	return success;
+}
+
+// Memory context detaching .
+static void sharedMemDetaches(channel_t * ptMem, int shmid, int role)
+{
+	struct shmid_ds shmds;
+
+	if (shmdt(ptMem) == -1)
+	{
+		printf("%s: memory detaching error(%d)\n", ((role == 0) ? "PARENT" : " CHILD"), errno);
+	}
+	else
+	{
+		// Update info .
+		if(shmctl(shmid, IPC_STAT, &shmds) == 0)
+		{
+			printf("%s: memory (created by pid %d) detached (currently remaining %d attached)\n", ((role == 0) ? "PARENT" : " CHILD"), (int) shmds.shm_cpid, (int) shmds.shm_nattch);
+		}
+		else
+		{
+			printf("%s: shmctl error=%d\n", ((role == 0) ? "PARENT" : " CHILD"), errno);
+		}
+	}
+}
+
+// Semaphore set creation: all slots empty, none full .
+static int semCreate (key_t key)
+{
+	int semid = semget(key, 2, 0666 | IPC_CREAT);
+
+	if ((semid == -1) || (semctl(semid, SEM_EMPTY, SETVAL, CHANNEL_SLOTS) == -1) || (semctl(semid, SEM_FULL, SETVAL, 0) == -1))
+	{
+		printf("Semaphore creation error (%d)\n", errno);
+		exit(-1);
+	}
+
+	printf("Semaphore set %d has been created\n", semid);
+
+	return semid;
+}
+
+// Semaphore set removing .
+static void semDelete (int semid)
+{
+	if (semctl(semid, 0, IPC_RMID) != -1)
+	{
+		printf("Semaphore set %d removed.\n", semid);
+	}
+}
+
+// Give-up path: the peer is dead, so nobody else will remove the IPC objects (the next run would find them) .
+static void ipcGiveUp (int role)
+{
+	if ((ipcShmid != -1) && (shmctl(ipcShmid, IPC_RMID, 0) == 0))
+	{
+		printf("%s: memory segment removed\n", ((role == 0) ? "PARENT" : " CHILD"));
+	}
+
+	if (ipcSemid != -1)
+	{
+		semDelete(ipcSemid);
+	}
+
+	exit(-1);
+}
+
+// Blocked decrement: bounded waits, every threshold spent blocked is reported with the holder (the peer) pid .
+static void semBoundedWait (int semid, int semNum, int op, int role)
+{
+	struct sembuf sb;
+	struct timespec timeout;
+	long long start, waitedNs;
+
+	sb.sem_num = semNum;
+	sb.sem_op = op;
+	sb.sem_flg = 0;
+
+	timeout.tv_sec = (STALL_THRESHOLD_MS * NSEC_PER_MS) / NSEC_PER_SEC;
+	timeout.tv_nsec = (STALL_THRESHOLD_MS * NSEC_PER_MS) % NSEC_PER_SEC;
+
+	start = timeNowNs();
+
+	while ( semtimedop(semid, &sb, 1, &timeout) == -1 )
+	{
+		if (errno == EAGAIN)
+		{
+			printf("%s: semaphore %d.%d stalled for %lld ms (holder pid %d)\n", ((role == 0) ? "PARENT" : " CHILD"), semid, semNum, (timeNowNs() - start) / NSEC_PER_MS, peerPid);
+
+			// A dead peer (or an own child already exited) will never post .
+			if ((peerPid > 0) && (((kill(peerPid, 0) == -1) && (errno == ESRCH)) || (waitpid(peerPid, NULL, WNOHANG) == peerPid)))
+			{
+				printf("%s: semaphore %d.%d holder (pid %d) is dead.\n", ((role == 0) ? "PARENT" : " CHILD"), semid, semNum, peerPid);
+				ipcGiveUp(role);
+			}
+		}
+		else if (errno != EINTR)
+		{
+			printf("%s: semaphore %d.%d operation failed.\n", ((role == 0) ? "PARENT" : " CHILD"), semid, semNum);
+			exit(-1);
+		}
+	}
+
+	// Wait statistics (blocked waits only) .
+	waitedNs = timeNowNs() - start;
+	blockedCount++;
+
+	if (waitedNs > waitMaxNs)
+	{
+		waitMaxNs = waitedNs;
+	}
+
+	if (waitedNs >= STALL_THRESHOLD_MS * NSEC_PER_MS)
+	{
+		stallCount++;
+		printf("%s: semaphore %d.%d wait took %lld ms (threshold %d ms)\n", ((role == 0) ? "PARENT" : " CHILD"), semid, semNum, waitedNs / NSEC_PER_MS, STALL_THRESHOLD_MS);
+	}
+}
+
+// System V semaphore operation (op can move several slots at once): false when IPC_NOWAIT would block .
+// Without IPC_NOWAIT a decrement that would block becomes a bounded wait .
+static bool semOperation (int semid, int semNum, int op, int flags, int role)
+{
+	struct sembuf sb;
+
+	sb.sem_num = semNum;
+	sb.sem_op = op;
+	sb.sem_flg = (op < 0) ? (flags | IPC_NOWAIT) : flags;
+
+	while ( semop(semid, &sb, 1) == -1 )
+	{
+		if ((errno == EAGAIN) && (flags & IPC_NOWAIT))
+		{
+			return false;
+		}
+
+		if (errno == EAGAIN)
+		{
+			semBoundedWait(semid, semNum, op, role);
+			break;
+		}
+
+		if (errno != EINTR)
+		{
+			printf("%s: semaphore %d.%d operation failed.\n", ((role == 0) ? "PARENT" : " CHILD"), semid, semNum);
+			exit(-1);
+		}
+	}
+
+	return true;
+}
+
+// io_uring setup by raw syscalls: rings mapping and the slots area registered as one fixed buffer .
+static bool uringSetup (uring_t * ring, unsigned int entries, void * buffer, size_t size)
+{
+	struct io_uring_params params;
+	struct iovec iov;
+
+	memset(ring, 0, sizeof(uring_t));
+	memset(&params, 0, sizeof(params));
+
+	ring->fd = (int) syscall(__NR_io_uring_setup, entries, &params);
+
+	if (ring->fd < 0)
+	{
+		return false;
+	}
+
+	ring->entries = params.sq_entries;
+	ring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+	ring->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+
+	// Submission and completion rings share one mapping on recent kernels .
+	if (params.features & IORING_FEAT_SINGLE_MMAP)
+	{
+		if (ring->cqRingSize > ring->sqRingSize)
+		{
+			ring->sqRingSize = ring->cqRingSize;
+		}
+
+		ring->cqRingSize = 0;
+	}
+
+	ring->sqRing = mmap(NULL, ring->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+	ring->cqRing = (ring->cqRingSize == 0) ? ring->sqRing : mmap(NULL, ring->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+	ring->sqes = mmap(NULL, params.sq_entries * sizeof(struct io_uring_sqe), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+
+	if ((ring->sqRing == MAP_FAILED) || (ring->cqRing == MAP_FAILED) || (ring->sqes == MAP_FAILED))
+	{
+		close(ring->fd);
+		return false;
+	}
+
+	ring->sqHead = (unsigned int *) ((char *) ring->sqRing + params.sq_off.head);
+	ring->sqTail = (unsigned int *) ((char *) ring->sqRing + params.sq_off.tail);
+	ring->sqMask = (unsigned int *) ((char *) ring->sqRing + params.sq_off.ring_mask);
+	ring->sqArray = (unsigned int *) ((char *) ring->sqRing + params.sq_off.array);
+	ring->cqHead = (unsigned int *) ((char *) ring->cqRing + params.cq_off.head);
+	ring->cqTail = (unsigned int *) ((char *) ring->cqRing + params.cq_off.tail);
+	ring->cqMask = (unsigned int *) ((char *) ring->cqRing + params.cq_off.ring_mask);
+	ring->cqes = (struct io_uring_cqe *) ((char *) ring->cqRing + params.cq_off.cqes);
+
+	// Registered buffer: pages pinned once, no per write mapping (plain writes when the memlock limit is too low) .
+	iov.iov_base = buffer;
+	iov.iov_len = size;
+	ring->fixed = (syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_BUFFERS, &iov, 1) == 0);
+
+	return true;
+}
+
+// io_uring release .
+static void uringRelease (uring_t * ring)
+{
+	munmap(ring->sqes, ring->entries * sizeof(struct io_uring_sqe));
+
+	if (ring->cqRing != ring->sqRing)
+	{
+		munmap(ring->cqRing, ring->cqRingSize);
+	}
+
+	munmap(ring->sqRing, ring->sqRingSize);
+	close(ring->fd);
+}
+
+// Write request queueing (published to the kernel by uringEnter) .
+static void uringQueueWrite (uring_t * ring, int fd, const void * buf, unsigned int length, long long offset, unsigned long long userData)
+{
+	unsigned int tail = *ring->sqTail;
+	unsigned int index = tail & *ring->sqMask;
+	struct io_uring_sqe * sqe = &ring->sqes[index];
+
+	memset(sqe, 0, sizeof(struct io_uring_sqe));
+	sqe->opcode = ring->fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+	sqe->fd = fd;
+	sqe->addr = (unsigned long long) (unsigned long) buf;
+	sqe->len = length;
+	sqe->off = offset;
+	sqe->buf_index = 0;
+	sqe->user_data = userData;
+
+	ring->sqArray[index] = index;
+
+	// Entry visible before the tail moves .
+	__atomic_store_n(ring->sqTail, tail + 1, __ATOMIC_RELEASE);
+}
+
+// Submit the queued requests, optionally waiting for completions: returns the requests the kernel took (-1 on error) .
+// The kernel may take fewer than asked, the others stay queued in the ring for the next call .
+static int uringEnter (uring_t * ring, unsigned int submit, unsigned int waitNr)
+{
+	int res;
+
+	do
+	{
+		res = (int) syscall(__NR_io_uring_enter, ring->fd, submit, waitNr, (waitNr > 0) ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+	}
+	while ((res < 0) && (errno == EINTR));
+
+	// Completion queue busy or no memory for now: nothing taken, retried by the next call .
+	if ((res < 0) && ((errno == EBUSY) || (errno == EAGAIN)))
+	{
+		res = 0;
+	}
+
+	return res;
+}
+
+// Completion reaping: returns the writes finished, their slot marked done .
+// A short write is queued again for the remaining bytes of the slot, at the matching file offset (*requeued) .
+static int uringReap (uring_t * ring, channel_t * ch, int fd, unsigned int * written, bool * done, int * requeued, sinkStats_t * stats, int role)
+{
+	unsigned int head = *ring->cqHead;
+	struct io_uring_cqe * cqe;
+	unsigned long long seq;
+	unsigned int slot;
+	int reaped = 0;
+
+	*requeued = 0;
+
+	while (head != __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE))
+	{
+		cqe = &ring->cqes[head & *ring->cqMask];
+		seq = cqe->user_data;
+		slot = (unsigned int) (seq % CHANNEL_SLOTS);
+		head++;
+
+		if (cqe->res > 0)
+		{
+			written[slot] += (unsigned int) cqe->res;
+
+			if (written[slot] < SLOT_SIZE)
+			{
+				stats->shortWrites++;
+				uringQueueWrite(ring, fd, (const char *) &ch->slot[slot] + written[slot], SLOT_SIZE - written[slot],
+				                (long long) seq * SLOT_SIZE + written[slot], seq);
+				(*requeued)++;
+				continue;
+			}
+		}
+		else
+		{
+			// Error, or no progress at all (retrying would loop) .
+			printf("%s: write of message %llu failed (%d)\n", ((role == 0) ? "PARENT" : " CHILD"), seq, cqe->res);
+			stats->writeErrors++;
+		}
+
+		written[slot] = 0;
+		done[slot] = true;
+		reaped++;
+	}
+
+	__atomic_store_n(ring->cqHead, head, __ATOMIC_RELEASE);
+
+	return reaped;
+}
+
+// io_uring sink: ready slots drained in batches, slots given back in order as their writes complete .
+static void sinkUring (channel_t * ch, int semid, int fd, uring_t * ring, sinkStats_t * stats, int role)
+{
+	bool done[CHANNEL_SLOTS];
+	unsigned int written[CHANNEL_SLOTS];
+	long long received = 0, released = 0;
+	int inFlight = 0, unsubmitted = 0, ready, batch, completed, submitted, requeued, n;
+
+	memset(done, 0, sizeof(done));
+	memset(written, 0, sizeof(written));
+
+	while (released < MESSAGE_NUMBER)
+	{
+		// Ready slots: only the sink takes them, so the current count can be taken in one operation .
+		ready = semctl(semid, SEM_FULL, GETVAL);
+		batch = ready;
+
+		if (batch > BATCH_MAX)
+		{
+			batch = BATCH_MAX;
+		}
+
+		if (batch > MESSAGE_NUMBER - received)
+		{
+			batch = (int) (MESSAGE_NUMBER - received);
+		}
+
+		// Nothing ready and nothing in flight: block for one message .
+		if ((batch == 0) && (inFlight == 0))
+		{
+			batch = 1;
+		}
+
+		if (batch > 0)
+		{
+			semOperation(semid, SEM_FULL, -batch, 0, role);
+
+			for (n=0; n < batch; n++)
+			{
+				uringQueueWrite(ring, fd, &ch->slot[received % CHANNEL_SLOTS], SLOT_SIZE, received * SLOT_SIZE, (unsigned long long) received);
+				received++;
+			}
+
+			inFlight += batch;
+			unsubmitted += batch;
+			stats->batches++;
+
+			if (inFlight > stats->maxInFlight)
+			{
+				stats->maxInFlight = inFlight;
+			}
+		}
+
+		// Submit everything still queued (a short submission leaves the rest for the next turn) .
+		// Wait for a completion only when there is no new message and some write is already in the kernel .
+		submitted = uringEnter(ring, unsubmitted, ((batch == 0) && (inFlight > unsubmitted)) ? 1 : 0);
+
+		if (submitted < 0)
+		{
+			printf("%s: io_uring_enter error (%d)\n", ((role == 0) ? "PARENT" : " CHILD"), errno);
+			exit(-1);
+		}
+
+		unsubmitted -= submitted;
+
+		inFlight -= uringReap(ring, ch, fd, written, done, &requeued, stats, role);
+		unsubmitted += requeued;
+
+		// Slots back to the producer in ring order, one operation for all the completed ones .
+		completed = 0;
+
+		while ((released + completed < received) && done[(released + completed) % CHANNEL_SLOTS])
+		{
+			done[(released + completed) % CHANNEL_SLOTS] = false;
+			completed++;
+		}
+
+		if (completed > 0)
+		{
+			semOperation(semid, SEM_EMPTY, completed, 0, role);
+			released += completed;
+		}
+	}
+}
+
+// Blocking sink: one write per message inside the read cycle .
+static void sinkPwrite (channel_t * ch, int semid, int fd, sinkStats_t * stats, int role)
+{
+	long long seq;
+
+	for (seq=0; seq < MESSAGE_NUMBER; seq++)
+	{
+		semOperation(semid, SEM_FULL, -1, 0, role);
+
+		if (pwrite(fd, &ch->slot[seq % CHANNEL_SLOTS], SLOT_SIZE, seq * SLOT_SIZE) != SLOT_SIZE)
+		{
+			stats->writeErrors++;
+		}
+
+		stats->batches++;
+
+		semOperation(semid, SEM_EMPTY, 1, 0, role);
+	}
+}
+
+// Splice sink: the page aligned slot is mapped into a pipe and moved to the file without a user copy .
+static void sinkSplice (channel_t * ch, int semid, int fd, sinkStats_t * stats, int role)
+{
+	struct iovec iov;
+	int pipeFd[2];
+	long long seq;
+	loff_t offset;
+	ssize_t res;
+	size_t moved;
+
+	if ((pipe(pipeFd) == -1) || (fcntl(pipeFd[1], F_SETPIPE_SZ, SLOT_SIZE) < SLOT_SIZE))
+	{
+		printf("%s: pipe setup error (%d)\n", ((role == 0) ? "PARENT" : " CHILD"), errno);
+		exit(-1);
+	}
+
+	for (seq=0; seq < MESSAGE_NUMBER; seq++)
+	{
+		semOperation(semid, SEM_FULL, -1, 0, role);
+
+		iov.iov_base = &ch->slot[seq % CHANNEL_SLOTS];
+		iov.iov_len = SLOT_SIZE;
+		offset = seq * SLOT_SIZE;
+		moved = 0;
+
+		// The pipe references the slot pages until splice has copied them to the page cache .
+		if (vmsplice(pipeFd[1], &iov, 1, 0) != SLOT_SIZE)
+		{
+			stats->writeErrors++;
+		}
+
+		while (moved < SLOT_SIZE)
+		{
+			res = splice(pipeFd[0], NULL, fd, &offset, SLOT_SIZE - moved, SPLICE_F_MOVE);
+
+			if (res <= 0)
+			{
+				stats->writeErrors++;
+				break;
+			}
+
+			moved += res;
+		}
+
+		stats->batches++;
+
+		semOperation(semid, SEM_EMPTY, 1, 0, role);
+	}
+
+	close(pipeFd[0]);
+	close(pipeFd[1]);
+}
+
+// Written file control: every record carries its sequence and pattern .
+static long long fileCheck (const char * path)
+{
+	message_t msg;
+	long long seq, errors = 0;
+	int fd = open(path, O_RDONLY);
+
+	if (fd == -1)
+	{
+		return MESSAGE_NUMBER;
+	}
+
+	for (seq=0; seq < MESSAGE_NUMBER; seq++)
+	{
+		// Item count checked before it is used as an index: a torn or foreign record can hold anything .
+		if ((pread(fd, &msg, SLOT_SIZE, seq * SLOT_SIZE) != SLOT_SIZE) || (msg.seq != seq) ||
+		    (msg.items <= 0) || (msg.items > (long long) (sizeof(msg.data) / sizeof(msg.data[0]))) ||
+		    (msg.data[0] != seq + OFFSET) || (msg.data[msg.items - 1] != seq + msg.items - 1 + OFFSET))
+		{
+			errors++;
+		}
+	}
+
+	close(fd);
+
+	return errors;
+}
+
+// Main routine: usage SharedMemoryDiskSink <file> [uring|pwrite|splice] .
+int main(int argc, char * argv[])
+{
+	int shmid, semid, retFork, status, fd, i;
+	channel_t * mem = NULL;
+	int role = -1;
+	sinkMode_t mode = SINK_URING;
+	sinkStats_t stats;
+	uring_t ring;
+	message_t * slot;
+	long long seq, start, elapsed, stallNs = 0, t;
+
+	if ((argc < 2) || (argc > 3))
+	{
+		printf("Usage: %s <file> [uring|pwrite|splice]\n", argv[0]);
+		return -1;
+	}
+
+	if (argc > 2)
+	{
+		for (mode=SINK_URING; mode <= SINK_SPLICE; mode++)
+		{
+			if (strcmp(argv[2], modeName[mode]) == 0)
+			{
+				break;
+			}
+		}
+
+		if (mode > SINK_SPLICE)
+		{
+			printf("Usage: %s <file> [uring|pwrite|splice]\n", argv[0]);
+			return -1;
+		}
+	}
+
+	// Signal callback registration .
+	signal(SIGINT, endProcessesSignaller);
+
+	// Shared memory and semaphores create .
+	shmid = sharedMemCreation(SHARED_MEM_ID);
+	semid = semCreate(SEM_ID);
+	ipcShmid = shmid;
+	ipcSemid = semid;
+
+	// Child creation (pending output is flushed first) .
+	fflush(stdout);
+	retFork = fork();
+
+	if (retFork > 0)
+	{
+		childPid = retFork;
+		peerPid = retFork;
+		role = 0;
+	}
+	else if (retFork == 0)
+	{
+		peerPid = getppid();
+		role = 1;
+	}
+	else
+	{
+		printf("PARENT: error trying to fork() (%d)\n", errno);
+		exit(-1);
+	}
+
+	if (!sharedMemAttach(shmid, role, &mem))
+	{
+		exit(-1);
+	}
+
+	if (role == 0)
+	{
+		// Producer: time blocked on a full channel is the sink stall seen upstream .
+		start = timeNowNs();
+
+		for (seq=0; seq < MESSAGE_NUMBER; seq++)
+		{
+			t = timeNowNs();
+			semOperation(semid, SEM_EMPTY, -1, 0, role);
+			stallNs += timeNowNs() - t;
+
+			slot = &mem->slot[seq % CHANNEL_SLOTS];
+			slot->seq = seq;
+			slot->items = sizeof(slot->data) / sizeof(slot->data[0]);
+
+			for (i=0; i < slot->items; i++)
+			{
+				slot->data[i] = seq + i + OFFSET;
+			}
+
+			semOperation(semid, SEM_FULL, 1, 0, role);
+		}
+
+		printf("PARENT: %d messages of %d bytes produced, %lld ms blocked on a full channel\n", MESSAGE_NUMBER, SLOT_SIZE, stallNs / 1000000);
+		printf("PARENT: %u blocked semaphore waits, max %lld us, %u over %d ms\n", blockedCount, waitMaxNs / 1000, stallCount, STALL_THRESHOLD_MS);
+
+		// Wait child ending before delete memory .
+		wait(&status);
+
+		elapsed = timeNowNs() - start;
+
+		printf("PARENT: %s sink done in %lld ms (%.1f MB/s), %lld bad records in %s\n", modeName[mode], elapsed / 1000000,
+		       (double) MESSAGE_NUMBER * SLOT_SIZE / (1024.0 * 1024.0) / ((double) elapsed / NSEC_PER_SEC), fileCheck(argv[1]), argv[1]);
+
+		semDelete(semid);
+
+		// Detaching memory .
+		sharedMemDetaches(mem, shmid, role);
+
+		// Removing memory .
+		if (shmctl( shmid, IPC_RMID, 0 ) == 0)
+		{
+			printf( "PARENT: memory segment removed\n");
+		}
+		else
+		{
+			printf( "PARENT: memory segment removing fail!\n" );
+		}
+	}
+	else
+	{
+		memset(&stats, 0, sizeof(stats));
+
+		fd = open(argv[1], O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+		if (fd == -1)
+		{
+			printf(" CHILD: %s open error (%d)\n", argv[1], errno);
+			exit(-1);
+		}
+
+		// No io_uring (old kernel, seccomp): blocking writes .
+		if ((mode == SINK_URING) && !uringSetup(&ring, BATCH_MAX * 2, mem, sizeof(channel_t)))
+		{
+			printf(" CHILD: io_uring not available (%d), pwrite fallback\n", errno);
+			mode = SINK_PWRITE;
+		}
+
+		if (mode == SINK_URING)
+		{
+			printf(" CHILD: io_uring sink, %s buffers\n", ring.fixed ? "registered" : "unregistered");
+			sinkUring(mem, semid, fd, &ring, &stats, role);
+			uringRelease(&ring);
+		}
+		else if (mode == SINK_SPLICE)
+		{
+			sinkSplice(mem, semid, fd, &stats, role);
+		}
+		else
+		{
+			sinkPwrite(mem, semid, fd, &stats, role);
+		}
+
+		// Persisted before reporting .
+		fdatasync(fd);
+		close(fd);
+
+		printf(" CHILD: %s sink, %lld batches (max %lld writes in flight), %lld write errors, %lld short writes resubmitted\n", modeName[mode], stats.batches, stats.maxInFlight, stats.writeErrors, stats.shortWrites);
+		printf(" CHILD: %u blocked semaphore waits, max %lld us, %u over %d ms\n", blockedCount, waitMaxNs / 1000, stallCount, STALL_THRESHOLD_MS);
+
+		// Memory detach .
+		sharedMemDetaches(mem, shmid, role);
+
+		printf(" CHILD: Exiting...\n");
+		fflush(stdout);
+
+		exit(0);
+	}
+
+	printf("PARENT: Exiting...\n");
+	fflush(stdout);
+
+	return 0;
+}
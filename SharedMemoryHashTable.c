@@ -0,0 +1,583 @@
+/* ============================================================================ **
+ **                           Embedded Linux                                     **
+ ** ============================================================================ **
+ **               +++++++++++++++++++++++++++++++++++++++                        **
+ **    Module:    +       SharedMemoryHashTable.c       +                        **
+ **               +++++++++++++++++++++++++++++++++++++++                        **
+ **                                                                              **
+ **  Description: This module implements a fixed capacity open addressing hash   **
+ **               table in the shared memory segment: lock-free readers (per     **
+ **               bucket version) and per bucket writer lock, with a multi       **
+ **               process read/write benchmark                                   **
+ **                                                                              **
+ ** ============================================================================ **
+ **         Edit                                      Data           Author      **
+ **    First release                                18/10/2026     F.Coppo       **
+ ** ============================================================================ */
+
+// Include .
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <sys/shm.h>
+#include <errno.h>
+#include <sys/wait.h>
+#include <stdbool.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <sys/sem.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <sched.h>
+#include <time.h>
+
+// Define .
+#define SHARED_MEM_ID          111
+#define MY_SEM_ID              112
+#define TABLE_CAPACITY         4096
+#define TABLE_MASK             (TABLE_CAPACITY - 1)
+#define KEY_RANGE              2048
+#define VALUE_WORDS            4
+#define WORKER_NUMBER          4
+#define OPS_PER_WORKER         200000
+#define READ_PERCENT           90
+#define NSEC_PER_SEC 1000000000LL
+#define NSEC_PER_MS     1000000LL
+#define STALL_THRESHOLD_MS     500
+
+// Bucket: key 0 means empty, version odd while a writer is inside .
+typedef struct
+{
+	_Atomic uint32_t  version;
+	_Atomic uint64_t  key;
+	_Atomic long long value[VALUE_WORDS];
+} __attribute__((aligned(64))) bucket_t;
+
+// Shared memory layout .
+typedef struct
+{
+	_Atomic uint32_t count;
+	bucket_t         bucket[TABLE_CAPACITY];
+} hashTable_t;
+
+// Local variables .
+static int childPid = 0;
+static int semid = -1;
+
+// Callback linked to SIGINT signal .
+void endProcessesSignaller (int sig_num)
+{
+	if (childPid == 0)
+	{
+		// Child kill request .
+		printf("Child kill request (pid %d)\n", (int) getpid());
+		printf("Child killing...\n");
+		kill(getpid(), SIGUSR1);
+	}
+	else
+	{
+		// Father kill request: the whole process group is killed .
+		printf("Father kill request (pid %d)\n", (int) getpid());
+		printf("Workers killing...\n");
+		kill(0, SIGUSR1);
+	}
+}
+
+// Monotonic time in nanoseconds .
+static long long timeNowNs (void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (long long) ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+// Key hash (64 bits mix) .
+static inline uint32_t keyHash (uint64_t key)
+{
+	key ^= key >> 33;
+	key *= 0xff51afd7ed558ccdULL;
+	key ^= key >> 33;
+
+	return (uint32_t) key & TABLE_MASK;
+}
+
+// Bucket writer lock: version from even to odd .
+static inline void bucketLock (bucket_t * bucket)
+{
+	uint32_t version;
+
+	for (;;)
+	{
+		version = atomic_load_explicit(&bucket->version, memory_order_relaxed);
+
+		if (((version & 1) == 0) &&
+		    atomic_compare_exchange_weak_explicit(&bucket->version, &version, version + 1, memory_order_acquire, memory_order_relaxed))
+		{
+			return;
+		}
+
+		sched_yield();
+	}
+}
+
+// Bucket writer unlock: version back to even (readers see a new version) .
+static inline void bucketUnlock (bucket_t * bucket)
+{
+	atomic_fetch_add_explicit(&bucket->version, 1, memory_order_release);
+}
+
+// Lookup without locks: the bucket is read again when its version changed meanwhile .
+static bool tableLookup (hashTable_t * table, uint64_t key, long long value[VALUE_WORDS])
+{
+	uint32_t index = keyHash(key);
+	uint32_t probe, v1, v2;
+	uint64_t bucketKey;
+	bucket_t * bucket;
+	int i;
+
+	for (probe=0; probe < TABLE_CAPACITY; probe++)
+	{
+		bucket = &table->bucket[(index + probe) & TABLE_MASK];
+
+		do
+		{
+			v1 = atomic_load_explicit(&bucket->version, memory_order_acquire);
+
+			bucketKey = atomic_load_explicit(&bucket->key, memory_order_relaxed);
+
+			for (i=0; i < VALUE_WORDS; i++)
+			{
+				value[i] = atomic_load_explicit(&bucket->value[i], memory_order_relaxed);
+			}
+
+			atomic_thread_fence(memory_order_acquire);
+			v2 = atomic_load_explicit(&bucket->version, memory_order_relaxed);
+		}
+		while (((v1 & 1) != 0) || (v1 != v2));
+
+		if (bucketKey == key)
+		{
+			return true;
+		}
+
+		if (bucketKey == 0)
+		{
+			return false;
+		}
+	}
+
+	return false;
+}
+
+// Insert or update under the lock of the target bucket only .
+static bool tableUpdate (hashTable_t * table, uint64_t key, const long long value[VALUE_WORDS])
+{
+	uint32_t index = keyHash(key);
+	uint32_t probe;
+	uint64_t bucketKey;
+	bucket_t * bucket;
+	int i;
+
+	for (probe=0; probe < TABLE_CAPACITY; probe++)
+	{
+		bucket = &table->bucket[(index + probe) & TABLE_MASK];
+		bucketKey = atomic_load_explicit(&bucket->key, memory_order_acquire);
+
+		if ((bucketKey != key) && (bucketKey != 0))
+		{
+			continue;
+		}
+
+		bucketLock(bucket);
+
+		// Key check again under lock: an empty bucket could have been taken meanwhile .
+		bucketKey = atomic_load_explicit(&bucket->key, memory_order_relaxed);
+
+		if ((bucketKey == key) || (bucketKey == 0))
+		{
+			if (bucketKey == 0)
+			{
+				atomic_store_explicit(&bucket->key, key, memory_order_relaxed);
+				atomic_fetch_add_explicit(&table->count, 1, memory_order_relaxed);
+			}
+
+			for (i=0; i < VALUE_WORDS; i++)
+			{
+				atomic_store_explicit(&bucket->value[i], value[i], memory_order_relaxed);
+			}
+
+			bucketUnlock(bucket);
+
+			return true;
+		}
+
+		bucketUnlock(bucket);
+	}
+
+	// Table full .
+	return false;
+}
+
+// Memory creation .
+static int sharedMemCreation (key_t key)
+{
+	struct shmid_ds shmds;
+
+	int shmid = shmget(key, sizeof(hashTable_t), 0666 | IPC_CREAT);
+
+	if (shmid >= 0)
+	{
+		// Info request .
+		if (shmctl(shmid, IPC_STAT, &shmds) == 0)
+		{
+			printf("%d bytes size shared memory created\n", (int) shmds.shm_segsz);
+		}
+		else
+		{
+			printf("shmctl error = %d\n", errno);
+		}
+	}
+	else
+	{
+		printf("PARENT: shared memory segment not found.\n");
+		exit(-1);
+	}
+
+	return shmid;
+}
+
+// Memory context attaching .
+static bool sharedMemAttach (int shmid, int role, hashTable_t * * ptPtMem)
+{
+	struct shmid_ds shmds;
+	bool success = true;
+
+	// Attach shmid memory .
+	*ptPtMem = (hashTable_t *) shmat(shmid, (const void *)0, 0);
+
+	// Info request .
+	if ((*ptPtMem != (hashTable_t *) -1) && (shmctl(shmid, IPC_STAT, &shmds) == 0))
+	{
+		printf("%s: context attached (currently %d attaches)\n", ((role == 0) ? "PARENT" : " CHILD"), (int) shmds.shm_nattch);
+	}
+	else
+	{
+		printf("%s: shmctl error = %d\n",((role == 0) ? "PARENT" : " CHILD"), errno);
+		success = false;
+	}
+
+	return success;
+}
+
+// Memory context detaching .
+static void sharedMemDetaches(hashTable_t * ptMem, int shmid, int role)
+{
+	struct shmid_ds shmds;
+
+	if (shmdt(ptMem) == -1)
+	{
+		printf("%s: memory detaching error(%d)\n", ((role == 0) ? "PARENT" : " CHILD"), errno);
+	}
+	else
+	{
+		// Update info .
+		if(shmctl(shmid, IPC_STAT, &shmds) == 0)
+		{
+			printf("%s: memory (created by pid %d) detached (currently remaining %d attached)\n", ((role == 0) ? "PARENT" : " CHILD"), (int) shmds.shm_cpid, (int) shmds.shm_nattch);
+		}
+		else
+		{
+			printf("%s: shmctl error=%d\n", ((role == 0) ? "PARENT" : " CHILD"), errno);
+		}
+	}
+}
+
+// Binary semaphore creation .
+static int semCreate (key_t key)
+{
+	int semid;
+
+	semid = semget(key, 1, 0666 | IPC_CREAT );
+
+	if (semid != -1)
+	{
+		printf( "Semaphore %d has been created\n", semid);
+	}
+
+	return semid;
+}
+
+// Binary semaphore removing .
+static void semDelete (int semid)
+{
+	int res = semctl(semid, 0, IPC_RMID);
+
+	if (res != -1)
+	{
+		printf("Semaphore removed.\n");
+	}
+}
+
+// Binary semaphore value setting .
+int semSetVal (int semid, int value)
+{
+	return semctl(semid, 0, SETVAL, value);
+}
+
+// Binary semaphore acquire (bounded wait): every threshold spent blocked is reported with the holder pid .
+void semAcquire (int semid, int role)
+{
+	struct sembuf sb;
+	struct timespec timeout;
+	long long start;
+	int holderPid, res;
+
+	sb.sem_num = 0;
+	sb.sem_op = -1;
+	sb.sem_flg = IPC_NOWAIT;
+
+	// Fast path: same single semop as an unbounded wait .
+	if ( semop(semid, &sb, 1) == 0 )
+	{
+		return;
+	}
+
+	if ( errno != EAGAIN )
+	{
+		printf("%s: semaphore %d acquisition failed.\n", ((role == 0) ? "PARENT" : " CHILD"), semid);
+		exit(-1);
+	}
+
+	start = timeNowNs();
+	sb.sem_flg = 0;
+
+	timeout.tv_sec = (STALL_THRESHOLD_MS * NSEC_PER_MS) / NSEC_PER_SEC;
+	timeout.tv_nsec = (STALL_THRESHOLD_MS * NSEC_PER_MS) % NSEC_PER_SEC;
+
+	while ( ((res = semtimedop(semid, &sb, 1, &timeout)) == -1) && ((errno == EAGAIN) || (errno == EINTR)) )
+	{
+		if (errno != EAGAIN)
+		{
+			continue;
+		}
+
+		// Holder: last process that operated on the semaphore (it acquired it, the value is zero) .
+		holderPid = semctl(semid, 0, GETPID);
+
+		printf("%s: semaphore %d stalled for %lld ms (holder pid %d)\n", ((role == 0) ? "PARENT" : " CHILD"), semid, (timeNowNs() - start) / NSEC_PER_MS, holderPid);
+
+		// A dead worker will never release: give up, the parent removes the IPC objects once every worker is gone .
+		if ((holderPid > 0) && (kill(holderPid, 0) == -1) && (errno == ESRCH))
+		{
+			printf("%s: semaphore %d holder (pid %d) is dead.\n", ((role == 0) ? "PARENT" : " CHILD"), semid, holderPid);
+			exit(-1);
+		}
+	}
+
+	if ( res == -1 )
+	{
+		printf("%s: semaphore %d acquisition failed.\n", ((role == 0) ? "PARENT" : " CHILD"), semid);
+		exit(-1);
+	}
+}
+
+// Binary semaphore release .
+void semRelease(int semid, int role)
+{
+	struct sembuf sb;
+
+	sb.sem_num = 0;
+	sb.sem_op = 1;
+	sb.sem_flg = 0;
+
+	if ( semop(semid, &sb, 1) == -1 )
+	{
+		printf("%s: semaphore %d acquisition failed.\n", ((role == 0) ? "PARENT" : " CHILD"), semid);
+		exit(-1);
+	}
+}
+
+// Worker benchmark: random mix of lookups and updates, torn values are counted .
+static void workerRun (hashTable_t * table, int worker, bool globalLock)
+{
+	long long value[VALUE_WORDS];
+	unsigned int seed = (unsigned int) getpid();
+	unsigned int torn = 0, missing = 0, reads = 0, writes = 0;
+	uint64_t key;
+	long long start, elapsed;
+	int op, i;
+
+	start = timeNowNs();
+
+	for (op=0; op < OPS_PER_WORKER; op++)
+	{
+		key = 1 + (uint64_t) (rand_r(&seed) % KEY_RANGE);
+
+		if (globalLock)
+		{
+			semAcquire(semid, 1);
+		}
+
+		if ((rand_r(&seed) % 100) < READ_PERCENT)
+		{
+			reads++;
+
+			if (tableLookup(table, key, value))
+			{
+				// All the words of a value are written together .
+				for (i=1; i < VALUE_WORDS; i++)
+				{
+					if (value[i] != value[0])
+					{
+						torn++;
+						break;
+					}
+				}
+			}
+			else
+			{
+				missing++;
+			}
+		}
+		else
+		{
+			writes++;
+
+			for (i=0; i < VALUE_WORDS; i++)
+			{
+				value[i] = ((long long) worker << 32) | op;
+			}
+
+			tableUpdate(table, key, value);
+		}
+
+		if (globalLock)
+		{
+			semRelease(semid, 1);
+		}
+	}
+
+	elapsed = timeNowNs() - start;
+
+	printf(" CHILD: worker %d, %u reads, %u writes, %lld ns/op, %.0f op/s, %u torn, %u missing\n",
+	       worker, reads, writes, elapsed / OPS_PER_WORKER, (double) OPS_PER_WORKER * NSEC_PER_SEC / (double) elapsed, torn, missing);
+}
+
+// Main routine: usage SharedMemoryHashTable [semaphore] (single semaphore over the whole table) .
+int main(int argc, char * argv[])
+{
+	long long value[VALUE_WORDS];
+	int shmid, retFork, status, worker, i;
+	hashTable_t * table = NULL;
+	int role = 0;
+	bool globalLock = (argc > 1) && (strcmp(argv[1], "semaphore") == 0);
+	uint64_t key;
+	long long start;
+
+	printf("Hash table %d buckets, %d workers, %d%% reads, %s\n", TABLE_CAPACITY, WORKER_NUMBER, READ_PERCENT, globalLock ? "single semaphore" : "bucket versioning");
+
+	// Signal callback registration .
+	signal(SIGINT, endProcessesSignaller);
+
+	// Shared memory create .
+	shmid = sharedMemCreation(SHARED_MEM_ID);
+
+	if (!sharedMemAttach(shmid, role, &table))
+	{
+		exit(-1);
+	}
+
+	memset(table, 0, sizeof(hashTable_t));
+
+	// Semaphore create (comparison mode only) .
+	if (globalLock)
+	{
+		semid = semCreate(MY_SEM_ID);
+
+		if ((semid < 0) || (semSetVal(semid, 1) == -1))
+		{
+			printf("Semaphore creation error\n");
+			exit(-1);
+		}
+	}
+
+	// Table prefill: half of the key range .
+	for (key=1; key <= KEY_RANGE; key += 2)
+	{
+		for (i=0; i < VALUE_WORDS; i++)
+		{
+			value[i] = (long long) key;
+		}
+
+		tableUpdate(table, key, value);
+	}
+
+	printf("PARENT: %u keys inserted\n", (unsigned int) atomic_load(&table->count));
+
+	start = timeNowNs();
+
+	// Workers creation (the attached segment is inherited) .
+	for (worker=0; worker < WORKER_NUMBER; worker++)
+	{
+		fflush(stdout);
+		retFork = fork();
+
+		if (retFork == 0)
+		{
+			childPid = 0;
+
+			printf(" CHILD: child process created (pid %d)\n", (int) getpid());
+
+			workerRun(table, worker, globalLock);
+
+			sharedMemDetaches(table, shmid, 1);
+
+			printf(" CHILD: Exiting...\n");
+			fflush(stdout);
+
+			exit(0);
+		}
+		else if (retFork > 0)
+		{
+			childPid = retFork;
+		}
+		else
+		{
+			printf("PARENT: error trying to fork() (%d)\n", errno);
+		}
+	}
+
+	// Wait workers ending before delete memory .
+	while (wait(&status) > 0)
+	{
+	}
+
+	printf("PARENT: %d ops in %lld ms, %u keys in the table\n", WORKER_NUMBER * OPS_PER_WORKER, (timeNowNs() - start) / 1000000, (unsigned int) atomic_load(&table->count));
+
+	// Detaching memory .
+	sharedMemDetaches(table, shmid, role);
+
+	// Removing memory .
+	if (shmctl( shmid, IPC_RMID, 0 ) == 0)
+	{
+		printf( "PARENT: memory segment removed\n");
+	}
+	else
+	{
+		printf( "PARENT: memory segment removing fail!\n" );
+	}
+
+	// Semaphore delete .
+	if (globalLock)
+	{
+		semDelete(semid);
+	}
+
+	printf("PARENT: Exiting...\n");
+	fflush(stdout);
+
+	return 0;
+}
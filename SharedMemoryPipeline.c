@@ -0,0 +1,828 @@
+/* ============================================================================ **
+ **                           Embedded Linux                                     **
+ ** ============================================================================ **
+ **               +++++++++++++++++++++++++++++++++++++++                        **
+ **    Module:    +       SharedMemoryPipeline.c        +                        **
+ **               +++++++++++++++++++++++++++++++++++++++                        **
+ **                                                                              **
+ **  Description: This module implements a N stages process pipeline (source,    **
+ **               transform stages and sink): adjacent stages are connected by   **
+ **               shared memory ring channels with semaphores (Unix system V)    **
+ **               and a per channel overflow policy (block or drop)              **
+ **                                                                              **
+ ** ============================================================================ **
+ **         Edit                                      Data           Author      **
+ **    First release                                18/10/2026     F.Coppo       **
+ ** ============================================================================ */
+
+// Include .
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <sys/shm.h>
+#include <errno.h>
+#include <sys/wait.h>
+#include <stdbool.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <sys/sem.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <time.h>
+
+// Define .
+#define SHARED_MEM_ID       111
+#define SEM_ID              112
+#define MSG_ITEMS            16
+#define CHANNEL_SLOTS        64
+#define MESSAGE_NUMBER   100000
+#define END_OF_STREAM       -1LL
+#define NSEC_PER_SEC 1000000000LL
+#define NSEC_PER_MS     1000000LL
+#define STALL_THRESHOLD_MS  500
+#define CACHE_LINE           64
+#define DECODE_ROUNDS        64
+
+// Semaphores of a channel (semaphore set index = channel * SEM_PER_CHANNEL + semaphore) .
+#define SEM_EMPTY             0
+#define SEM_FULL              1
+#define SEM_TAIL              2
+#define SEM_PER_CHANNEL       3
+
+// Channel overflow policy: what the producer does on a full channel .
+typedef enum
+{
+	OVERFLOW_BLOCK = 0,
+	OVERFLOW_DROP_OLDEST,
+	OVERFLOW_DROP_NEWEST,
+	OVERFLOW_POLICY_NUMBER
+} overflowPolicy_t;
+
+// Message moved through the pipeline .
+typedef struct
+{
+	long long seq;
+	long long data[MSG_ITEMS];
+} message_t;
+
+// Ring channel between two adjacent stages (single producer, single consumer) .
+typedef struct
+{
+	unsigned int head;
+	int          policy;
+	long long    dropped;
+	long long    overwritten;
+	char         pad1[CACHE_LINE - sizeof(unsigned int) - sizeof(int) - 2 * sizeof(long long)];
+	unsigned int tail;
+	long long    overwrittenSeen;
+	char         pad2[CACHE_LINE - sizeof(unsigned int) - sizeof(long long)];
+	message_t    slot[CHANNEL_SLOTS];
+} channel_t;
+
+// Per stage statistics (written by the stage, read by the parent at the end) .
+typedef struct
+{
+	long long msgIn;
+	long long msgOut;
+	long long busyNs;
+	long long elapsedNs;
+	long long depthSum;
+	long long depthMax;
+	long long gapEvents;
+	long long gapLost;
+	long long waitMaxNs;
+	long long stalls;
+	int       pid;
+	int       cpu;
+} __attribute__((aligned(CACHE_LINE))) stageStats_t;
+
+// Stage work: returns false when the message must not be forwarded .
+typedef bool (* stageWork_t) (message_t * msg);
+
+// Stage description .
+typedef struct
+{
+	const char * name;
+	stageWork_t  work;
+} stageDesc_t;
+
+// Local variables .
+static int childPid = 0;
+static unsigned long long sinkTotal = 0;
+static long long waitMaxNs = 0;
+static long long stallCount = 0;
+static const char * policyName[OVERFLOW_POLICY_NUMBER] = { "block", "drop-oldest", "drop-newest" };
+
+// Stage work routines .
+static bool decodeStage (message_t * msg);
+static bool filterStage (message_t * msg);
+static bool aggregateStage (message_t * msg);
+
+// Pipeline description: first stage is the source, last stage is the sink .
+static const stageDesc_t pipeline[] =
+{
+	{ "source",    NULL           },
+	{ "decode",    decodeStage    },
+	{ "filter",    filterStage    },
+	{ "aggregate", aggregateStage },
+};
+
+#define STAGE_NUMBER   ((int) (sizeof(pipeline) / sizeof(pipeline[0])))
+#define CHANNEL_NUMBER (STAGE_NUMBER - 1)
+
+// Shared memory layout .
+typedef struct
+{
+	stageStats_t stats[STAGE_NUMBER];
+	channel_t    channel[CHANNEL_NUMBER];
+} shmLayout_t;
+
+// Attached layout (stage pids for the stall report) .
+static shmLayout_t * sharedMem = NULL;
+
+// Callback linked to SIGINT signal .
+void endProcessesSignaller (int sig_num)
+{
+	if (childPid == 0)
+	{
+		// Stage kill request .
+		printf("Stage kill request (pid %d)\n", (int) getpid());
+		kill(getpid(), SIGUSR1);
+	}
+	else
+	{
+		// Father kill request: the whole process group is killed .
+		printf("Father kill request (pid %d)\n", (int) getpid());
+		printf("Pipeline killing...\n");
+		kill(0, SIGUSR1);
+	}
+}
+
+// Monotonic time in nanoseconds .
+static long long timeNowNs (void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (long long) ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+// Decode: payload expansion from the sequence number (the most expensive stage), wrapping unsigned arithmetic .
+static bool decodeStage (message_t * msg)
+{
+	int i, round;
+
+	for (round=0; round < DECODE_ROUNDS; round++)
+	{
+		for (i=1; i < MSG_ITEMS; i++)
+		{
+			msg->data[i] = (long long) ((unsigned long long) msg->data[i-1] * 31 + (unsigned long long) msg->seq + (unsigned long long) round);
+		}
+	}
+
+	return true;
+}
+
+// Filter: one message every four is discarded .
+static bool filterStage (message_t * msg)
+{
+	return ((msg->seq & 3) != 0);
+}
+
+// Aggregate: running sum of the payload (modulo 2^64, the decoded values wrap) .
+static bool aggregateStage (message_t * msg)
+{
+	int i;
+
+	for (i=0; i < MSG_ITEMS; i++)
+	{
+		sinkTotal += (unsigned long long) msg->data[i];
+	}
+
+	return true;
+}
+
+// Memory creation .
+static int sharedMemCreation (key_t key)
+{
+	struct shmid_ds shmds;
+
+	int shmid = shmget(key, sizeof(shmLayout_t), 0666 | IPC_CREAT);
+
+	if (shmid >= 0)
+	{
+		// Info request .
+		if (shmctl(shmid, IPC_STAT, &shmds) == 0)
+		{
+			printf("%d bytes size shared memory created\n", (int) shmds.shm_segsz);
+		}
+		else
+		{
+			printf("shmctl error = %d\n", errno);
+		}
+	}
+	else
+	{
+		printf("PARENT: shared memory segment not found.\n");
+		exit(-1);
+	}
+
+	return shmid;
+}
+
+// Memory context attaching .
+static bool sharedMemAttach (int shmid, const char * name, shmLayout_t * * ptPtMem)
+{
+	struct shmid_ds shmds;
+	bool success = true;
+
+	// Attach shmid memory .
+	*ptPtMem = (shmLayout_t *) shmat(shmid, (const void *)0, 0);
+
+	// Info request .
+	if ((*ptPtMem != (shmLayout_t *) -1) && (shmctl(shmid, IPC_STAT, &shmds) == 0))
+	{
+		printf("%9s: context attached (currently %d attaches)\n", name, (int) shmds.shm_nattch);
+	}
+	else
+	{
+		printf("%9s: shmctl error = %d\n", name, errno);
+		success = false;
+	}
+
+	return success;
+}
+
+// Memory context detaching .
+static void sharedMemDetaches(shmLayout_t * ptMem, int shmid, const char * name)
+{
+	struct shmid_ds shmds;
+
+	if (shmdt(ptMem) == -1)
+	{
+		printf("%9s: memory detaching error(%d)\n", name, errno);
+	}
+	else
+	{
+		// Update info .
+		if(shmctl(shmid, IPC_STAT, &shmds) == 0)
+		{
+			printf("%9s: memory (created by pid %d) detached (currently remaining %d attached)\n", name, (int) shmds.shm_cpid, (int) shmds.shm_nattch);
+		}
+		else
+		{
+			printf("%9s: shmctl error=%d\n", name, errno);
+		}
+	}
+}
+
+// Channel semaphores creation: EMPTY counts free slots, FULL counts ready messages, TAIL locks the read side .
+static int semCreate (key_t key, int channels)
+{
+	int semid, i;
+
+	semid = semget(key, channels * SEM_PER_CHANNEL, 0666 | IPC_CREAT );
+
+	if (semid != -1)
+	{
+		for (i=0; i < channels; i++)
+		{
+			if ((semctl(semid, i * SEM_PER_CHANNEL + SEM_EMPTY, SETVAL, CHANNEL_SLOTS) == -1) ||
+			    (semctl(semid, i * SEM_PER_CHANNEL + SEM_FULL, SETVAL, 0) == -1) ||
+			    (semctl(semid, i * SEM_PER_CHANNEL + SEM_TAIL, SETVAL, 1) == -1))
+			{
+				semctl(semid, 0, IPC_RMID);
+				return -1;
+			}
+		}
+
+		printf( "Semaphore set %d has been created (%d channels)\n", semid, channels);
+	}
+
+	return semid;
+}
+
+// Semaphore set removing .
+static void semDelete (int semid)
+{
+	int res = semctl(semid, 0, IPC_RMID);
+
+	if (res != -1)
+	{
+		printf("Semaphore set %d removed.\n", semid);
+	}
+}
+
+// Holder of a channel semaphore: the stage expected to post it (the tail lock holder is its last operator) .
+static int semHolder (int semid, int semNum)
+{
+	int chIndex = semNum / SEM_PER_CHANNEL;
+
+	if ((semNum % SEM_PER_CHANNEL) == SEM_EMPTY)
+	{
+		return sharedMem->stats[chIndex + 1].pid;
+	}
+	else if ((semNum % SEM_PER_CHANNEL) == SEM_FULL)
+	{
+		return sharedMem->stats[chIndex].pid;
+	}
+
+	return semctl(semid, semNum, GETPID);
+}
+
+// Blocked decrement: bounded waits, every threshold spent blocked is reported with the holder stage pid .
+static void semBoundedWait (int semid, int semNum, int op, const char * name)
+{
+	struct sembuf sb;
+	struct timespec timeout;
+	long long start, waitedNs;
+	int holderPid;
+
+	sb.sem_num = semNum;
+	sb.sem_op = op;
+	sb.sem_flg = 0;
+
+	timeout.tv_sec = (STALL_THRESHOLD_MS * NSEC_PER_MS) / NSEC_PER_SEC;
+	timeout.tv_nsec = (STALL_THRESHOLD_MS * NSEC_PER_MS) % NSEC_PER_SEC;
+
+	start = timeNowNs();
+
+	while ( semtimedop(semid, &sb, 1, &timeout) == -1 )
+	{
+		if (errno == EAGAIN)
+		{
+			holderPid = semHolder(semid, semNum);
+
+			printf("%9s: semaphore %d.%d stalled for %lld ms (holder pid %d)\n", name, semid, semNum, (timeNowNs() - start) / NSEC_PER_MS, holderPid);
+
+			// A dead stage will never post: give up, the parent removes the IPC objects once every stage is gone .
+			if ((holderPid > 0) && (kill(holderPid, 0) == -1) && (errno == ESRCH))
+			{
+				printf("%9s: semaphore %d.%d holder (pid %d) is dead.\n", name, semid, semNum, holderPid);
+				exit(-1);
+			}
+		}
+		else if (errno != EINTR)
+		{
+			printf("%9s: semaphore %d.%d operation failed.\n", name, semid, semNum);
+			exit(-1);
+		}
+	}
+
+	// Wait statistics (blocked waits only) .
+	waitedNs = timeNowNs() - start;
+
+	if (waitedNs > waitMaxNs)
+	{
+		waitMaxNs = waitedNs;
+	}
+
+	if (waitedNs >= STALL_THRESHOLD_MS * NSEC_PER_MS)
+	{
+		stallCount++;
+		printf("%9s: semaphore %d.%d wait took %lld ms (threshold %d ms)\n", name, semid, semNum, waitedNs / NSEC_PER_MS, STALL_THRESHOLD_MS);
+	}
+}
+
+// Semaphore operation on one semaphore of the set: a decrement that would block becomes a bounded wait .
+static void semOperation (int semid, int semNum, int op, const char * name)
+{
+	struct sembuf sb;
+
+	sb.sem_num = semNum;
+	sb.sem_op = op;
+	sb.sem_flg = (op < 0) ? IPC_NOWAIT : 0;
+
+	while ( semop(semid, &sb, 1) == -1 )
+	{
+		if (errno == EAGAIN)
+		{
+			semBoundedWait(semid, semNum, op, name);
+			break;
+		}
+
+		if (errno != EINTR)
+		{
+			printf("%9s: semaphore %d.%d operation failed.\n", name, semid, semNum);
+			exit(-1);
+		}
+	}
+}
+
+// Semaphore decrement without waiting: false when it would block .
+static bool semTryDecrement (int semid, int semNum, const char * name)
+{
+	struct sembuf sb;
+
+	sb.sem_num = semNum;
+	sb.sem_op = -1;
+	sb.sem_flg = IPC_NOWAIT;
+
+	while ( semop(semid, &sb, 1) == -1 )
+	{
+		if (errno == EAGAIN)
+		{
+			return false;
+		}
+
+		if (errno != EINTR)
+		{
+			printf("%9s: semaphore %d.%d operation failed.\n", name, semid, semNum);
+			exit(-1);
+		}
+	}
+
+	return true;
+}
+
+// Channel publish: gets a free slot as the overflow policy says, copies the message and signals the consumer .
+// Returns false when the message is dropped (the end of stream marker always waits) .
+static bool channelSend (channel_t * ch, int semid, int chIndex, const message_t * msg, const char * name)
+{
+	int sem = chIndex * SEM_PER_CHANNEL;
+	bool stolen = false;
+
+	if ((ch->policy == OVERFLOW_BLOCK) || (msg->seq == END_OF_STREAM))
+	{
+		semOperation(semid, sem + SEM_EMPTY, -1, name);
+	}
+	else if (ch->policy == OVERFLOW_DROP_NEWEST)
+	{
+		// Full channel: the new message is discarded at publish time .
+		if (!semTryDecrement(semid, sem + SEM_EMPTY, name))
+		{
+			ch->dropped++;
+			return false;
+		}
+	}
+	else
+	{
+		// Full channel: the oldest ready message is taken away from the reader, its slot is the head one .
+		while (!stolen && !semTryDecrement(semid, sem + SEM_EMPTY, name))
+		{
+			semOperation(semid, sem + SEM_TAIL, -1, name);
+
+			if (semTryDecrement(semid, sem + SEM_FULL, name))
+			{
+				ch->tail++;
+				ch->overwritten++;
+				stolen = true;
+			}
+
+			semOperation(semid, sem + SEM_TAIL, 1, name);
+		}
+	}
+
+	ch->slot[ch->head % CHANNEL_SLOTS] = *msg;
+	ch->head++;
+
+	semOperation(semid, sem + SEM_FULL, 1, name);
+
+	return true;
+}
+
+// Channel receive: waits a ready message, copies it and gives the slot back .
+// Returns the messages overwritten since the previous receive (drop-oldest gap) .
+static long long channelReceive (channel_t * ch, int semid, int chIndex, message_t * msg, const char * name)
+{
+	int sem = chIndex * SEM_PER_CHANNEL;
+	long long gap = 0;
+
+	semOperation(semid, sem + SEM_FULL, -1, name);
+
+	// With drop-oldest the producer may move the tail: the slot copy is done under the tail lock .
+	if (ch->policy == OVERFLOW_DROP_OLDEST)
+	{
+		semOperation(semid, sem + SEM_TAIL, -1, name);
+
+		*msg = ch->slot[ch->tail % CHANNEL_SLOTS];
+		ch->tail++;
+
+		gap = ch->overwritten - ch->overwrittenSeen;
+		ch->overwrittenSeen = ch->overwritten;
+
+		semOperation(semid, sem + SEM_TAIL, 1, name);
+	}
+	else
+	{
+		*msg = ch->slot[ch->tail % CHANNEL_SLOTS];
+		ch->tail++;
+	}
+
+	semOperation(semid, sem + SEM_EMPTY, 1, name);
+
+	return gap;
+}
+
+// Stage process body .
+static void stageRun (shmLayout_t * mem, int semid, int stage)
+{
+	const char * name = pipeline[stage].name;
+	stageStats_t * stats = &mem->stats[stage];
+	bool isSource = (stage == 0);
+	bool isSink = (stage == STAGE_NUMBER - 1);
+	message_t msg;
+	long long start, busyStart, depth, gap, seq = 0;
+	cpu_set_t cpuSet;
+	bool running = true;
+
+	// One core per stage (wrap around on small machines) .
+	CPU_ZERO(&cpuSet);
+	CPU_SET(stage % (int) sysconf(_SC_NPROCESSORS_ONLN), &cpuSet);
+	sched_setaffinity(0, sizeof(cpuSet), &cpuSet);
+
+	stats->pid = (int) getpid();
+	stats->cpu = sched_getcpu();
+
+	start = timeNowNs();
+
+	while (running)
+	{
+		if (isSource)
+		{
+			// Source: message generation .
+			busyStart = timeNowNs();
+
+			if (seq < MESSAGE_NUMBER)
+			{
+				memset(&msg, 0, sizeof(msg));
+				msg.seq = seq++;
+				msg.data[0] = msg.seq;
+			}
+			else
+			{
+				msg.seq = END_OF_STREAM;
+				running = false;
+			}
+
+			stats->busyNs += timeNowNs() - busyStart;
+
+			// Dropped messages are not counted out (the source never waits with a drop policy) .
+			if (channelSend(&mem->channel[stage], semid, stage, &msg, name) && running)
+			{
+				stats->msgOut++;
+			}
+		}
+		else
+		{
+			// Input queue depth sampled before each receive .
+			depth = semctl(semid, (stage - 1) * SEM_PER_CHANNEL + SEM_FULL, GETVAL);
+			stats->depthSum += depth;
+			if (depth > stats->depthMax)
+			{
+				stats->depthMax = depth;
+			}
+
+			// Messages overwritten upstream since the previous receive .
+			gap = channelReceive(&mem->channel[stage - 1], semid, stage - 1, &msg, name);
+
+			if (gap > 0)
+			{
+				stats->gapEvents++;
+				stats->gapLost += gap;
+			}
+
+			if (msg.seq == END_OF_STREAM)
+			{
+				running = false;
+			}
+			else
+			{
+				stats->msgIn++;
+
+				busyStart = timeNowNs();
+				if (!pipeline[stage].work(&msg))
+				{
+					// Filtered out .
+					stats->busyNs += timeNowNs() - busyStart;
+					continue;
+				}
+				stats->busyNs += timeNowNs() - busyStart;
+			}
+
+			// Forward (the end of stream marker too) .
+			if (!isSink)
+			{
+				if (channelSend(&mem->channel[stage], semid, stage, &msg, name) && running)
+				{
+					stats->msgOut++;
+				}
+			}
+			else if (running)
+			{
+				stats->msgOut++;
+			}
+		}
+	}
+
+	stats->elapsedNs = timeNowNs() - start;
+	stats->waitMaxNs = waitMaxNs;
+	stats->stalls = stallCount;
+
+	if (isSink)
+	{
+		printf("%9s: aggregated total %llu\n", name, sinkTotal);
+	}
+}
+
+// Pipeline report: throughput, busy time and input queue depth per stage .
+static void pipelineReport (shmLayout_t * mem)
+{
+	int stage, bottleneck = 0;
+	double busy, maxBusy = 0.0;
+	long long lost, maxLost = 0;
+
+	for (stage=0; stage < STAGE_NUMBER; stage++)
+	{
+		busy = (double) mem->stats[stage].busyNs / (double) mem->stats[stage].elapsedNs;
+
+		if (busy > maxBusy)
+		{
+			maxBusy = busy;
+			bottleneck = stage;
+		}
+	}
+
+	// With a drop policy the slow stage does not stall the others, it loses messages: the reader of the channel losing the most is the bottleneck .
+	for (stage=0; stage < CHANNEL_NUMBER; stage++)
+	{
+		lost = mem->channel[stage].dropped + mem->channel[stage].overwritten;
+
+		if (lost > maxLost)
+		{
+			maxLost = lost;
+			bottleneck = stage + 1;
+		}
+	}
+
+	printf("\n%-9s %7s %4s %10s %10s %12s %6s %10s %9s %9s %6s\n", "stage", "pid", "cpu", "msg in", "msg out", "msg/s", "busy", "avg depth", "max depth", "max wait", "stalls");
+
+	for (stage=0; stage < STAGE_NUMBER; stage++)
+	{
+		stageStats_t * stats = &mem->stats[stage];
+		// The source rate is the generated one: messages sent plus the ones dropped at its output .
+		long long received = (stage == 0) ? stats->msgOut + mem->channel[0].dropped : stats->msgIn;
+
+		printf("%-9s %7d %4d %10lld %10lld %12.0f %5.1f%% %10.1f %9lld %7lldms %6lld%s\n",
+		       pipeline[stage].name,
+		       stats->pid,
+		       stats->cpu,
+		       stats->msgIn,
+		       stats->msgOut,
+		       (double) received * NSEC_PER_SEC / (double) stats->elapsedNs,
+		       100.0 * (double) stats->busyNs / (double) stats->elapsedNs,
+		       (stage == 0) ? 0.0 : (double) stats->depthSum / (double) (stats->msgIn + 1),
+		       stats->depthMax,
+		       stats->waitMaxNs / NSEC_PER_MS,
+		       stats->stalls,
+		       (stage == bottleneck) ? ((maxLost > 0) ? "  <- bottleneck (input overflows)" : "  <- bottleneck") : "");
+	}
+
+	// Losses per channel: producer side drops and gaps seen by the reader .
+	printf("\n%-20s %-12s %12s %12s %12s %12s\n", "channel", "policy", "dropped new", "overwritten", "gaps seen", "gap msgs");
+
+	for (stage=0; stage < CHANNEL_NUMBER; stage++)
+	{
+		channel_t * ch = &mem->channel[stage];
+		char chName[32];
+
+		snprintf(chName, sizeof(chName), "%s->%s", pipeline[stage].name, pipeline[stage + 1].name);
+
+		printf("%-20s %-12s %12lld %12lld %12lld %12lld\n", chName, policyName[ch->policy], ch->dropped, ch->overwritten,
+		       mem->stats[stage + 1].gapEvents, mem->stats[stage + 1].gapLost);
+	}
+
+	printf("\n");
+}
+
+// Overflow policy from its name (-1 if unknown) .
+static int policyParse (const char * text)
+{
+	int policy;
+
+	for (policy=0; policy < OVERFLOW_POLICY_NUMBER; policy++)
+	{
+		if (strcmp(text, policyName[policy]) == 0)
+		{
+			return policy;
+		}
+	}
+
+	return -1;
+}
+
+// Main routine: usage SharedMemoryPipeline [policy ...] (one for all channels or one per channel, block if omitted) .
+int main(int argc, char * argv[])
+{
+	int shmid, semid, stage, status;
+	int retFork;
+	shmLayout_t * mem = NULL;
+	int policy[CHANNEL_NUMBER];
+
+	if ((argc != 1) && (argc != 2) && (argc != CHANNEL_NUMBER + 1))
+	{
+		printf("Usage: %s [block|drop-oldest|drop-newest ...] (one for all channels or %d)\n", argv[0], CHANNEL_NUMBER);
+		return -1;
+	}
+
+	for (stage=0; stage < CHANNEL_NUMBER; stage++)
+	{
+		policy[stage] = (argc == 1) ? OVERFLOW_BLOCK : policyParse(argv[(argc == 2) ? 1 : stage + 1]);
+
+		if (policy[stage] < 0)
+		{
+			printf("Usage: %s [block|drop-oldest|drop-newest ...] (one for all channels or %d)\n", argv[0], CHANNEL_NUMBER);
+			return -1;
+		}
+	}
+
+	// Signal callback registration .
+	signal(SIGINT, endProcessesSignaller);
+
+	// Shared memory create (statistics and channels) .
+	shmid = sharedMemCreation(SHARED_MEM_ID);
+
+	if (!sharedMemAttach(shmid, "PARENT", &mem))
+	{
+		exit(-1);
+	}
+
+	memset(mem, 0, sizeof(shmLayout_t));
+	sharedMem = mem;
+
+	for (stage=0; stage < CHANNEL_NUMBER; stage++)
+	{
+		mem->channel[stage].policy = policy[stage];
+	}
+
+	// Channels semaphores create .
+	semid = semCreate(SEM_ID, CHANNEL_NUMBER);
+
+	if (semid < 0)
+	{
+		printf("Semaphore creation error\n");
+		exit(-1);
+	}
+
+	// One process per stage (the attached segment is inherited) .
+	for (stage=0; stage < STAGE_NUMBER; stage++)
+	{
+		fflush(stdout);
+		retFork = fork();
+
+		if (retFork == 0)
+		{
+			// A stage has no children: its SIGINT handler must take the stage branch .
+			childPid = 0;
+
+			printf("%9s: stage process created (pid %d)\n", pipeline[stage].name, (int) getpid());
+
+			stageRun(mem, semid, stage);
+
+			sharedMemDetaches(mem, shmid, pipeline[stage].name);
+
+			printf("%9s: Exiting...\n", pipeline[stage].name);
+			fflush(stdout);
+
+			exit(0);
+		}
+		else if (retFork > 0)
+		{
+			childPid = retFork;
+			mem->stats[stage].pid = retFork;
+		}
+		else
+		{
+			printf("PARENT: error trying to fork() (%d)\n", errno);
+		}
+	}
+
+	// Wait all stages ending before delete memory .
+	while (wait(&status) > 0)
+	{
+	}
+
+	pipelineReport(mem);
+
+	// Detaching memory .
+	sharedMemDetaches(mem, shmid, "PARENT");
+
+	// Removing memory .
+	if (shmctl( shmid, IPC_RMID, 0 ) == 0)
+	{
+		printf( "PARENT: memory segment removed\n");
+	}
+	else
+	{
+		printf( "PARENT: memory segment removing fail!\n" );
+	}
+
+	// Semaphores delete .
+	semDelete(semid);
+
+	printf("PARENT: Exiting...\n");
+	fflush(stdout);
+
+	return 0;
+}
@@ -0,0 +1,820 @@
+/* ============================================================================ **
+ **                           Embedded Linux                                     **
+ ** ============================================================================ **
+ **             +++++++++++++++++++++++++++++++++++++++++++                      **
+ **    Module:  + SharedMemoryPthreadSynchronization.c    +                      **
+ **             +++++++++++++++++++++++++++++++++++++++++++                      **
+ **                                                                              **
+ **  Description: This module compares Unix system V semaphores with process     **
+ **               shared (robust) pthread mutex and condition variables placed   **
+ **               inside the shared memory segment                               **
+ **                                                                              **
+ ** ============================================================================ **
+ **         Edit                                      Data           Author      **
+ **    First release                                18/10/2026     F.Coppo       **
+ ** ============================================================================ */
+
+// Include .
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <sys/shm.h>
+#include <errno.h>
+#include <sys/wait.h>
+#include <stdbool.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <sys/sem.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+// Define .
+#define BUFFER_SIZE          16
+#define OFFSET            65000
+#define SHARED_MEM_ID       111
+#define SEM_ID_LOCK         112
+#define SEM_ID_1            113
+#define SEM_ID_2            114
+#define CYCLE_NUMBER      20000
+#define STALL_THRESHOLD_MS  500
+#define NSEC_PER_MS     1000000LL
+#define NSEC_PER_SEC 1000000000LL
+
+// Synchronization backend .
+typedef enum
+{
+	SYNC_SYSV = 0,
+	SYNC_PTHREAD
+} syncBackend_t;
+
+// Process shared counting semaphore (mutex + condition variable) .
+typedef struct
+{
+	pthread_mutex_t mutex;
+	pthread_cond_t  cond;
+	int             count;
+	int             holderPid;  // Last process operating on it (as SysV sempid) .
+} pthreadSem_t;
+
+// Shared memory layout: synchronization objects followed by the data buffer .
+typedef struct
+{
+	pthreadSem_t lock;
+	pthreadSem_t sem1;
+	pthreadSem_t sem2;
+	long long    data[BUFFER_SIZE];
+} shmLayout_t;
+
+// Backend independent semaphore handle .
+typedef struct
+{
+	syncBackend_t  backend;
+	int            semid;
+	pthreadSem_t * ptSem;
+} syncSem_t;
+
+// Local variables .
+static int childPid = 0;
+static int ownPid = 0;
+static int peerPid = 0;
+static int ipcShmid = -1;
+static int ipcSemid[3] = { -1, -1, -1 };
+static long long stallThresholdNs = STALL_THRESHOLD_MS * NSEC_PER_MS;
+static unsigned int fastCount = 0;
+static unsigned int waitCount = 0;
+static unsigned int stallCount = 0;
+static long long waitMaxNs = 0;
+static long long waitTotalNs = 0;
+
+// Callback linked to SIGINT signal .
+void endProcessesSignaller (int sig_num)
+{
+	if (childPid == 0)
+	{
+		// Child kill request .
+		printf("Child kill request (pid %d)\n", (int) getpid());
+		printf("Child killing...\n");
+		kill(getpid(), SIGUSR1);
+	}
+	else
+	{
+		// Father kill request: also the child is killed .
+		printf("Father kill request (pid %d)\n", (int) getpid());
+		printf("Child killing...\n");
+		kill(childPid, SIGUSR1);
+		printf("Father killing...\n");
+		kill(getpid(), SIGUSR1);
+	}
+}
+
+// Monotonic time in nanoseconds .
+static long long timeNowNs (void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (long long) ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+// Memory creation .
+static int sharedMemCreation (key_t key)
+{
+	struct shmid_ds shmds;
+
+	int shmid = shmget(key, sizeof(shmLayout_t), 0666 | IPC_CREAT);
+
+	if (shmid >= 0)
+	{
+		// Info request .
+		if (shmctl(shmid, IPC_STAT, &shmds) == 0)
+		{
+			printf("%d bytes size shared memory created\n", (int) shmds.shm_segsz);
+		}
+		else
+		{
+			printf("shmctl error = %d\n", errno);
+		}
+	}
+	else
+	{
+		printf("PARENT: shared memory segment not found.\n");
+		exit(-1);
+	}
+
+	return shmid;
+}
+
+// Memory context attaching .
+static bool sharedMemAttach (int shmid, int role, shmLayout_t * * ptPtMem)
+{
+	struct shmid_ds shmds;
+	bool success = true;
+
+	// Attach shmid memory .
+	*ptPtMem = (shmLayout_t *) shmat(shmid, (const void *)0, 0);
+
+	// Info request .
+	if ((*ptPtMem != (shmLayout_t *) -1) && (shmctl(shmid, IPC_STAT, &shmds) == 0))
+	{
+		printf("%s: context attached (currently %d attaches)\n", ((role == 0) ? "PARENT" : " CHILD"), (int) shmds.shm_nattch);
+	}
+	else
+	{
+		printf("%s: shmctl error = %d\n",((role == 0) ? "PARENT" : " CHILD"), errno);
+		success = false;
+	}
+
+	return success;
+}
+
+// Memory context detaching .
+static void sharedMemDetaches(shmLayout_t * ptMem, int shmid, int role)
+{
+	struct shmid_ds shmds;
+
+	if (shmdt(ptMem) == -1)
+	{
+		printf("%s: memory detaching error(%d)\n", ((role == 0) ? "PARENT" : " CHILD"), errno);
+	}
+	else
+	{
+		// Update info .
+		if(shmctl(shmid, IPC_STAT, &shmds) == 0)
+		{
+			printf("%s: memory (created by pid %d) detached (currently remaining %d attached)\n", ((role == 0) ? "PARENT" : " CHILD"), (int) shmds.shm_cpid, (int) shmds.shm_nattch);
+		}
+		else
+		{
+			printf("%s: shmctl error=%d\n", ((role == 0) ? "PARENT" : " CHILD"), errno);
+		}
+	}
+}
+
+// Absolute deadline one stall threshold from now on the given clock .
+static void deadlineSet (struct timespec * ts, clockid_t clock)
+{
+	long long deadlineNs;
+
+	clock_gettime(clock, ts);
+
+	deadlineNs = (long long) ts->tv_sec * NSEC_PER_SEC + ts->tv_nsec + stallThresholdNs;
+	ts->tv_sec = deadlineNs / NSEC_PER_SEC;
+	ts->tv_nsec = deadlineNs % NSEC_PER_SEC;
+}
+
+// Holder pid, looked up on the slow path only: when the last operation was our own the peer is the one expected to post .
+static int holderOf (int semid, const pthreadSem_t * ptSem)
+{
+	int holderPid = (ptSem != NULL) ? ptSem->holderPid : semctl(semid, 0, GETPID);
+
+	return (holderPid == ownPid) ? peerPid : holderPid;
+}
+
+// Holder liveness (an own child already exited counts as dead) .
+static bool holderDead (int holderPid)
+{
+	return (holderPid > 0) && (((kill(holderPid, 0) == -1) && (errno == ESRCH)) || (waitpid(holderPid, NULL, WNOHANG) == holderPid));
+}
+
+// Give-up path: the peer is dead, so nobody else will remove the IPC objects (the next run would find them) .
+static void ipcGiveUp (int role)
+{
+	int i;
+
+	if ((ipcShmid != -1) && (shmctl(ipcShmid, IPC_RMID, 0) == 0))
+	{
+		printf("%s: memory segment removed\n", ((role == 0) ? "PARENT" : " CHILD"));
+	}
+
+	for (i=0; i < 3; i++)
+	{
+		if ((ipcSemid[i] != -1) && (semctl(ipcSemid[i], 0, IPC_RMID) != -1))
+		{
+			printf("%s: semaphore %d removed\n", ((role == 0) ? "PARENT" : " CHILD"), ipcSemid[i]);
+		}
+	}
+
+	exit(-1);
+}
+
+// Still blocked after one more threshold: report, give up when the holder is dead .
+static void waitStalled (const char * name, long long start, int semid, const pthreadSem_t * ptSem, int role)
+{
+	int holderPid = holderOf(semid, ptSem);
+
+	printf("%s: %s stalled for %lld ms (holder pid %d)\n", ((role == 0) ? "PARENT" : " CHILD"), name, (timeNowNs() - start) / NSEC_PER_MS, holderPid);
+
+	if (holderDead(holderPid))
+	{
+		printf("%s: %s holder (pid %d) is dead.\n", ((role == 0) ? "PARENT" : " CHILD"), name, holderPid);
+		ipcGiveUp(role);
+	}
+}
+
+// Wait statistics update for a wait that blocked, waits over the threshold are reported .
+static void waitRecord (const char * name, long long start, int semid, const pthreadSem_t * ptSem, int role)
+{
+	long long waitedNs = timeNowNs() - start;
+
+	waitCount++;
+	waitTotalNs += waitedNs;
+
+	if (waitedNs > waitMaxNs)
+	{
+		waitMaxNs = waitedNs;
+	}
+
+	if (waitedNs >= stallThresholdNs)
+	{
+		stallCount++;
+		printf("%s: %s wait took %lld ms (threshold %lld ms, holder pid %d)\n", ((role == 0) ? "PARENT" : " CHILD"), name, waitedNs / NSEC_PER_MS, stallThresholdNs / NSEC_PER_MS, holderOf(semid, ptSem));
+	}
+}
+
+// Wait statistics report (and reset for the next backend) .
+static void waitReport (const char * backend, int role)
+{
+	printf("%s: %-7s %u uncontended, %u blocked waits (blocked: max %lld us, mean %lld us), %u over %lld ms\n", ((role == 0) ? "PARENT" : " CHILD"), backend,
+	       fastCount, waitCount, waitMaxNs / 1000, (waitCount > 0) ? (waitTotalNs / waitCount) / 1000 : 0, stallCount, stallThresholdNs / NSEC_PER_MS);
+
+	fastCount = 0;
+	waitCount = 0;
+	stallCount = 0;
+	waitMaxNs = 0;
+	waitTotalNs = 0;
+}
+
+// Robust mutex bounded lock: a mutex left locked by a dead process is recovered .
+// Returns the wait start time, 0 when the mutex was free (no clock read on the fast path) .
+static long long pthreadLock (pthreadSem_t * ptSem, int role)
+{
+	struct timespec deadline;
+	long long start = 0;
+	int res = pthread_mutex_trylock(&ptSem->mutex);
+
+	while ((res == EBUSY) || (res == ETIMEDOUT))
+	{
+		if (start == 0)
+		{
+			start = timeNowNs();
+		}
+		else
+		{
+			waitStalled("pthread mutex", start, -1, ptSem, role);
+		}
+
+		// Mutex timed lock works on the realtime clock only .
+		deadlineSet(&deadline, CLOCK_REALTIME);
+		res = pthread_mutex_timedlock(&ptSem->mutex, &deadline);
+	}
+
+	if (res == EOWNERDEAD)
+	{
+		printf("%s: mutex owner died, state recovered.\n", ((role == 0) ? "PARENT" : " CHILD"));
+		pthread_mutex_consistent(&ptSem->mutex);
+	}
+	else if (res != 0)
+	{
+		printf("%s: mutex lock failed (%d).\n", ((role == 0) ? "PARENT" : " CHILD"), res);
+		exit(-1);
+	}
+
+	return start;
+}
+
+// Process shared pthread semaphore initialization .
+static bool pthreadSemInit (pthreadSem_t * ptSem, int value)
+{
+	pthread_mutexattr_t mutexAttr;
+	pthread_condattr_t condAttr;
+	bool success = true;
+
+	pthread_mutexattr_init(&mutexAttr);
+	pthread_mutexattr_setpshared(&mutexAttr, PTHREAD_PROCESS_SHARED);
+	pthread_mutexattr_setrobust(&mutexAttr, PTHREAD_MUTEX_ROBUST);
+
+	pthread_condattr_init(&condAttr);
+	pthread_condattr_setpshared(&condAttr, PTHREAD_PROCESS_SHARED);
+	pthread_condattr_setclock(&condAttr, CLOCK_MONOTONIC);
+
+	if ((pthread_mutex_init(&ptSem->mutex, &mutexAttr) != 0) || (pthread_cond_init(&ptSem->cond, &condAttr) != 0))
+	{
+		success = false;
+	}
+
+	ptSem->count = value;
+	ptSem->holderPid = 0;
+
+	pthread_condattr_destroy(&condAttr);
+	pthread_mutexattr_destroy(&mutexAttr);
+
+	return success;
+}
+
+// Semaphore creation (value is the initial count) .
+static bool semCreate (syncSem_t * ptSync, syncBackend_t backend, key_t key, pthreadSem_t * ptSem, int value)
+{
+	bool success = false;
+
+	ptSync->backend = backend;
+	ptSync->semid = -1;
+	ptSync->ptSem = ptSem;
+
+	if (backend == SYNC_SYSV)
+	{
+		ptSync->semid = semget(key, 1, 0666 | IPC_CREAT );
+
+		if ((ptSync->semid != -1) && (semctl(ptSync->semid, 0, SETVAL, value) != -1))
+		{
+			printf("Semaphore %d has been created (count = %d)\n", ptSync->semid, value);
+			success = true;
+		}
+	}
+	else
+	{
+		if (pthreadSemInit(ptSem, value))
+		{
+			printf("Pthread semaphore has been created (count = %d)\n", value);
+			success = true;
+		}
+	}
+
+	return success;
+}
+
+// Semaphore removing .
+static void semDelete (syncSem_t * ptSync)
+{
+	if (ptSync->backend == SYNC_SYSV)
+	{
+		if (semctl(ptSync->semid, 0, IPC_RMID) != -1)
+		{
+			printf("Semaphore %d removed.\n", ptSync->semid);
+		}
+	}
+	else
+	{
+		pthread_cond_destroy(&ptSync->ptSem->cond);
+		pthread_mutex_destroy(&ptSync->ptSem->mutex);
+		printf("Pthread semaphore removed.\n");
+	}
+}
+
+// System V semaphore operation: a decrement that would block becomes a bounded wait .
+static void semOperation (int semid, int op, int role)
+{
+	struct sembuf sb;
+	struct timespec timeout;
+	long long start;
+	int res;
+
+	sb.sem_num = 0;
+	sb.sem_op = op;
+	sb.sem_flg = (op < 0) ? IPC_NOWAIT : 0;
+
+	// Fast path: same single semop as an unbounded wait .
+	if ( semop(semid, &sb, 1) == 0 )
+	{
+		fastCount += (op < 0);
+		return;
+	}
+
+	if ( (op >= 0) || (errno != EAGAIN) )
+	{
+		printf("%s: semaphore %d operation failed.\n", ((role == 0) ? "PARENT" : " CHILD"), semid);
+		exit(-1);
+	}
+
+	start = timeNowNs();
+	sb.sem_flg = 0;
+
+	timeout.tv_sec = stallThresholdNs / NSEC_PER_SEC;
+	timeout.tv_nsec = stallThresholdNs % NSEC_PER_SEC;
+
+	// Every threshold elapsed the holder (last pid operating) is checked .
+	while ( ((res = semtimedop(semid, &sb, 1, &timeout)) == -1) && (errno == EAGAIN) )
+	{
+		waitStalled("semaphore", start, semid, NULL, role);
+	}
+
+	if ( res == -1 )
+	{
+		printf("%s: semaphore %d operation failed.\n", ((role == 0) ? "PARENT" : " CHILD"), semid);
+		exit(-1);
+	}
+
+	waitRecord("semaphore", start, semid, NULL, role);
+}
+
+// Mutual exclusion acquire .
+void semAcquire (syncSem_t * ptSync, int role)
+{
+	if (ptSync->backend == SYNC_SYSV)
+	{
+		semOperation(ptSync->semid, -1, role);
+	}
+	else
+	{
+		pthreadSem_t * ptSem = ptSync->ptSem;
+		long long start = pthreadLock(ptSem, role);
+
+		if (start != 0)
+		{
+			waitRecord("pthread mutex", start, -1, ptSem, role);
+		}
+		else
+		{
+			fastCount++;
+		}
+
+		ptSem->holderPid = ownPid;
+	}
+}
+
+// Mutual exclusion release .
+void semRelease (syncSem_t * ptSync, int role)
+{
+	if (ptSync->backend == SYNC_SYSV)
+	{
+		semOperation(ptSync->semid, 1, role);
+	}
+	else
+	{
+		pthread_mutex_unlock(&ptSync->ptSem->mutex);
+	}
+}
+
+// Wait (count decrement, blocking while zero) .
+void semWait (syncSem_t * ptSync, int role)
+{
+	if (ptSync->backend == SYNC_SYSV)
+	{
+		semOperation(ptSync->semid, -1, role);
+	}
+	else
+	{
+		pthreadSem_t * ptSem = ptSync->ptSem;
+		struct timespec deadline;
+		long long start = pthreadLock(ptSem, role);
+		int res;
+
+		while (ptSem->count == 0)
+		{
+			if (start == 0)
+			{
+				start = timeNowNs();
+			}
+
+			// Condition variable clock is monotonic (see pthreadSemInit) .
+			deadlineSet(&deadline, CLOCK_MONOTONIC);
+			res = pthread_cond_timedwait(&ptSem->cond, &ptSem->mutex, &deadline);
+
+			if (res == EOWNERDEAD)
+			{
+				printf("%s: mutex owner died, state recovered.\n", ((role == 0) ? "PARENT" : " CHILD"));
+				pthread_mutex_consistent(&ptSem->mutex);
+			}
+			else if ((res == ETIMEDOUT) && (ptSem->count == 0))
+			{
+				waitStalled("pthread semaphore", start, -1, ptSem, role);
+			}
+		}
+
+		if (start != 0)
+		{
+			waitRecord("pthread semaphore", start, -1, ptSem, role);
+		}
+		else
+		{
+			fastCount++;
+		}
+
+		ptSem->count--;
+		ptSem->holderPid = ownPid;
+
+		pthread_mutex_unlock(&ptSem->mutex);
+	}
+}
+
+// Signal (count increment, wake up one waiter) .
+void semSignal (syncSem_t * ptSync, int role)
+{
+	if (ptSync->backend == SYNC_SYSV)
+	{
+		semOperation(ptSync->semid, 1, role);
+	}
+	else
+	{
+		pthreadSem_t * ptSem = ptSync->ptSem;
+
+		pthreadLock(ptSem, role);
+		ptSem->count++;
+		ptSem->holderPid = ownPid;
+		pthread_cond_signal(&ptSem->cond);
+		pthread_mutex_unlock(&ptSem->mutex);
+	}
+}
+
+// Mutual exclusion test: both processes access the buffer inside semAcquire/semRelease .
+static unsigned int mutexTest (shmLayout_t * mem, syncSem_t * ptLock, int role)
+{
+	long long tmpBuff[BUFFER_SIZE];
+	unsigned int errors = 0;
+	unsigned int cycle = CYCLE_NUMBER;
+	int i;
+
+	while(cycle--)
+	{
+		semAcquire(ptLock, role);
+
+		// Start of critical section .
+		if (role == 0)
+		{
+			for (i=0; i < BUFFER_SIZE; i++)
+			{
+				mem->data[i] = (long long) i + OFFSET;
+				mem->data[i] = mem->data[i]*2;
+				mem->data[i] = mem->data[i]/2;
+			}
+		}
+		else
+		{
+			for (i=0; i < BUFFER_SIZE; i++)
+			{
+				tmpBuff[i] = mem->data[i];
+			}
+		}
+		// End of critical section .
+
+		semRelease(ptLock, role);
+
+		// Values pattern control (child only, buffer could be still empty at the first cycles) .
+		if (role != 0)
+		{
+			for (i=0; i < BUFFER_SIZE; i++)
+			{
+				if ((tmpBuff[i] != 0) && (tmpBuff[i] != (long long) i + OFFSET))
+				{
+					errors++;
+					break;
+				}
+			}
+		}
+	}
+
+	return errors;
+}
+
+// Wait-signal test: parent produces, child consumes .
+static unsigned int waitSignalTest (shmLayout_t * mem, syncSem_t * ptSem1, syncSem_t * ptSem2, int role)
+{
+	long long tmpBuff[BUFFER_SIZE];
+	unsigned int errors = 0;
+	unsigned int cycle = CYCLE_NUMBER;
+	int i;
+
+	while(cycle--)
+	{
+		if (role == 0)
+		{
+			semWait(ptSem1, role);
+
+			for (i=0; i < BUFFER_SIZE; i++)
+			{
+				mem->data[i] = (long long) i + OFFSET + cycle;
+			}
+
+			semSignal(ptSem2, role);
+		}
+		else
+		{
+			semWait(ptSem2, role);
+
+			for (i=0; i < BUFFER_SIZE; i++)
+			{
+				tmpBuff[i] = mem->data[i];
+			}
+
+			semSignal(ptSem1, role);
+
+			// Values pattern control (out from critical section) .
+			for (i=0; i < BUFFER_SIZE; i++)
+			{
+				if (tmpBuff[i] != (long long) i + OFFSET + cycle)
+				{
+					errors++;
+					break;
+				}
+			}
+		}
+	}
+
+	return errors;
+}
+
+// Complete parent/child run with the selected backend .
+static void runBackend (syncBackend_t backend)
+{
+	const char * name = (backend == SYNC_SYSV) ? "SYSV" : "PTHREAD";
+	int shmid, retFork, status;
+	shmLayout_t * mem = NULL;
+	int role = -1;
+	syncSem_t lock, sem1, sem2;
+	unsigned int errors;
+	long long start, mutexNs, waitSignalNs;
+
+	// Shared memory create .
+	shmid = sharedMemCreation(SHARED_MEM_ID);
+
+	// Pthread objects live inside the segment: attach it before the fork .
+	if (!sharedMemAttach(shmid, 0, &mem))
+	{
+		exit(-1);
+	}
+
+	memset(mem, 0, sizeof(shmLayout_t));
+
+	// Lock unlocked, semaphores 1 and 2 locked (the child unlocks semaphore 1 when ready to consume) .
+	if (!semCreate(&lock, backend, SEM_ID_LOCK, &mem->lock, 1) ||
+	    !semCreate(&sem1, backend, SEM_ID_1, &mem->sem1, 0) ||
+	    !semCreate(&sem2, backend, SEM_ID_2, &mem->sem2, 0))
+	{
+		printf("Semaphore creation error\n");
+		exit(-1);
+	}
+
+	ipcShmid = shmid;
+	ipcSemid[0] = lock.semid;
+	ipcSemid[1] = sem1.semid;
+	ipcSemid[2] = sem2.semid;
+
+	// Child creation (the attached segment is inherited, pending output is flushed first) .
+	fflush(stdout);
+	retFork = fork();
+
+	// Child pid update .
+	if (retFork > 0)
+	{
+		childPid = retFork;
+		ownPid = (int) getpid();
+		peerPid = retFork;
+		role = 0;
+		printf("PARENT: process created (pid %d)\n", (int) getpid());
+	}
+	else if (retFork == 0)
+	{
+		ownPid = (int) getpid();
+		peerPid = getppid();
+		role = 1;
+		printf(" CHILD: child process created (pid %d)\n", (int) getpid());
+	}
+	else
+	{
+		printf("CHILD: error trying to fork() (%d)\n", errno);
+		exit(-1);
+	}
+
+	// Mutual exclusion test .
+	start = timeNowNs();
+	errors = mutexTest(mem, &lock, role);
+	mutexNs = timeNowNs() - start;
+
+	printf("%s: %-7s acquire/release %d cycles, %lld ns/cycle, %u sequence errors\n", ((role == 0) ? "PARENT" : " CHILD"), name, CYCLE_NUMBER, mutexNs / CYCLE_NUMBER, errors);
+
+	// Child ready: the parent starts writing only after the mutual exclusion test is over .
+	if (role != 0)
+	{
+		semSignal(&sem1, role);
+	}
+
+	// Wait-signal test .
+	start = timeNowNs();
+	errors = waitSignalTest(mem, &sem1, &sem2, role);
+	waitSignalNs = timeNowNs() - start;
+
+	printf("%s: %-7s wait/signal     %d cycles, %lld ns/cycle, %u sequence errors\n", ((role == 0) ? "PARENT" : " CHILD"), name, CYCLE_NUMBER, waitSignalNs / CYCLE_NUMBER, errors);
+	waitReport(name, role);
+
+	if (role == 0)
+	{
+		// Wait child ending before delete memory .
+		retFork = wait(&status);
+
+		// Semaphores delete (pthread objects first, they live in the segment) .
+		semDelete(&lock);
+		semDelete(&sem1);
+		semDelete(&sem2);
+
+		// Detaching memory .
+		sharedMemDetaches(mem, shmid, role);
+
+		// Removing memory .
+		if (shmctl( shmid, IPC_RMID, 0 ) == 0)
+		{
+			printf( "PARENT: memory segment removed\n");
+		}
+		else
+		{
+			printf( "PARENT: memory segment removing fail!\n" );
+		}
+
+		childPid = 0;
+	}
+	else
+	{
+		// Memory detach .
+		sharedMemDetaches(mem, shmid, role);
+
+		printf(" CHILD: Exiting...\n");
+		fflush(stdout);
+
+		exit(0);
+	}
+}
+
+// Main routine: usage SharedMemoryPthreadSynchronization [sysv|pthread] [stall threshold ms] (both backends if omitted) .
+int main(int argc, char * argv[])
+{
+	bool runSysV = true;
+	bool runPthread = true;
+	int arg = 1;
+
+	if ((argc > arg) && ((strcmp(argv[arg], "sysv") == 0) || (strcmp(argv[arg], "pthread") == 0)))
+	{
+		runSysV = (strcmp(argv[arg], "sysv") == 0);
+		runPthread = !runSysV;
+		arg++;
+	}
+
+	if (argc > arg)
+	{
+		stallThresholdNs = atoll(argv[arg]) * NSEC_PER_MS;
+		arg++;
+	}
+
+	if ((argc > arg) || (stallThresholdNs <= 0))
+	{
+		printf("Usage: %s [sysv|pthread] [stall threshold ms]\n", argv[0]);
+		return -1;
+	}
+
+	// Signal callback registration .
+	signal(SIGINT, endProcessesSignaller);
+
+	if (runSysV)
+	{
+		runBackend(SYNC_SYSV);
+	}
+
+	if (runPthread)
+	{
+		runBackend(SYNC_PTHREAD);
+	}
+
+	printf("PARENT: Exiting...\n");
+	fflush(stdout);
+
+	return 0;
+}
@@ -14,6 +14,7 @@
  ** ============================================================================ */
 
 // Include .
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <sys/shm.h>
 #include <errno.h>
@@ -23,6 +24,7 @@
 #include <unistd.h>
 #include <sys/sem.h>
 #include <stdlib.h>
+#include <time.h>
 
 // Define .
 #define BUFFER_SIZE          16
@@ -31,9 +33,20 @@
 #define SHARED_MEM_ID       111
 #define MY_SEM_ID           112
 #define CYCLE_NUMBER        100
+#define STALL_THRESHOLD_MS  500
+#define NSEC_PER_MS     1000000LL
+#define NSEC_PER_SEC 1000000000LL
 
 // Local variables .
 static int childPid = 0;
+static int ipcShmid = -1;
+static int ipcSemid[2] = { -1, -1 };
+static long long stallThresholdNs = STALL_THRESHOLD_MS * NSEC_PER_MS;
+static unsigned int fastCount = 0;
+static unsigned int waitCount = 0;
+static unsigned int stallCount = 0;
+static long long waitMaxNs = 0;
+static long long waitTotalNs = 0;
 
 // Callback linked to SIGINT signal .
 void endProcessesSignaller (int sig_num)
@@ -162,19 +175,119 @@ int semSetVal (int semid, int value)
 	return semctl(semid, 0, SETVAL, value);
 }
 
-// Binary semaphore acquire .
-void semAcquire (int semid, int role)
+// Monotonic time in nanoseconds .
+static long long timeNowNs (void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (long long) ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+// Bounded semaphore decrement: every threshold spent blocked is reported with the holder pid .
+static bool semBoundedDecrement (int semid, int role)
 {
 	struct sembuf sb;
+	struct timespec timeout;
+	long long start, waitedNs;
+	int holderPid;
 
 	sb.sem_num = 0;
 	sb.sem_op = -1;
 	sb.sem_flg = 0;
 
-	if ( semop(semid, &sb, 1) == -1 )
+	timeout.tv_sec = stallThresholdNs / NSEC_PER_SEC;
+	timeout.tv_nsec = stallThresholdNs % NSEC_PER_SEC;
+
+	// Fast path: the semaphore is free, same single semop as an unbounded wait .
+	sb.sem_flg = IPC_NOWAIT;
+
+	if ( semop(semid, &sb, 1) == 0 )
+	{
+		fastCount++;
+		return true;
+	}
+
+	sb.sem_flg = 0;
+
+	// Holder: last process that operated on the semaphore (it acquired it, the value is zero), looked up only when blocked .
+	holderPid = semctl(semid, 0, GETPID);
+	start = timeNowNs();
+
+	while ( semtimedop(semid, &sb, 1, &timeout) == -1 )
+	{
+		if (errno == EAGAIN)
+		{
+			printf("%s: semaphore %d stalled for %lld ms (holder pid %d)\n", ((role == 0) ? "PARENT" : " CHILD"), semid, (timeNowNs() - start) / NSEC_PER_MS, holderPid);
+
+			// A dead holder (or an own child already exited) will never release the semaphore .
+			if ((holderPid > 0) && (((kill(holderPid, 0) == -1) && (errno == ESRCH)) || (waitpid(holderPid, NULL, WNOHANG) == holderPid)))
+			{
+				printf("%s: semaphore %d holder (pid %d) is dead.\n", ((role == 0) ? "PARENT" : " CHILD"), semid, holderPid);
+				return false;
+			}
+		}
+		else if (errno != EINTR)
+		{
+			return false;
+		}
+	}
+
+	// Wait statistics .
+	waitedNs = timeNowNs() - start;
+	waitCount++;
+	waitTotalNs += waitedNs;
+
+	if (waitedNs > waitMaxNs)
+	{
+		waitMaxNs = waitedNs;
+	}
+
+	if (waitedNs >= stallThresholdNs)
+	{
+		stallCount++;
+		printf("%s: semaphore %d wait took %lld ms (threshold %lld ms, holder pid %d)\n", ((role == 0) ? "PARENT" : " CHILD"), semid, waitedNs / NSEC_PER_MS, stallThresholdNs / NSEC_PER_MS, holderPid);
+	}
+
+	return true;
+}
+
+// Give-up path: the peer is dead, so nobody else will remove the IPC objects (the next run would find them) .
+static void ipcGiveUp (int role)
+{
+	int i;
+
+	if ((ipcShmid != -1) && (shmctl(ipcShmid, IPC_RMID, 0) == 0))
+	{
+		printf("%s: memory segment removed\n", ((role == 0) ? "PARENT" : " CHILD"));
+	}
+
+	for (i=0; i < 2; i++)
+	{
+		if ((ipcSemid[i] != -1) && (semctl(ipcSemid[i], 0, IPC_RMID) != -1))
+		{
+			printf("%s: semaphore %d removed\n", ((role == 0) ? "PARENT" : " CHILD"), ipcSemid[i]);
+		}
+	}
+
+	exit(-1);
+}
+
+// Wait statistics report .
+static void semWaitReport (int role)
+{
+	printf("%s: %u uncontended, %u blocked semaphore waits (blocked: max %lld us, mean %lld us), %u over %lld ms\n", ((role == 0) ? "PARENT" : " CHILD"),
+	       fastCount, waitCount, waitMaxNs / 1000, (waitCount > 0) ? (waitTotalNs / waitCount) / 1000 : 0, stallCount, stallThresholdNs / NSEC_PER_MS);
+}
+
+// Binary semaphore acquire (bounded wait) .
+void semAcquire (int semid, int role)
+{
+	if ( !semBoundedDecrement(semid, role) )
 	{
 		printf("%s: semaphore %d acquisition failed.\n", ((role == 0) ? "PARENT" : " CHILD"), semid);
-		exit(-1);
+		ipcGiveUp(role);
 	}
 }
 
@@ -194,8 +307,8 @@ void semRelease(int semid, int role)
 	}
 }
 
-// Main routine .
-int main()
+// Main routine: usage SharedMemorySemaphore [stall threshold ms] .
+int main(int argc, char * argv[])
 {
 	long long tmpBuff[BUFFER_SIZE];
 	int shmid, retFork, i, status;
@@ -204,6 +317,12 @@ int main()
 	int semid;
 	unsigned int cycle = CYCLE_NUMBER;
 
+	// Stall threshold (optional argument) .
+	if ((argc > 1) && (atoll(argv[1]) > 0))
+	{
+		stallThresholdNs = atoll(argv[1]) * NSEC_PER_MS;
+	}
+
 	// Signal callback registration .
 	signal(SIGINT, endProcessesSignaller);
 
@@ -212,6 +331,8 @@ int main()
 
 	// Semaphore create .
 	semid = semCreate(MY_SEM_ID);
+	ipcShmid = shmid;
+	ipcSemid[0] = semid;
 
 	// Semaphore unlock (set value equal 1).
 	if (semid >= 0)
@@ -341,6 +462,8 @@ int main()
 		printf("CHILD: error trying to fork() (%d)\n", errno);
 	}
 
+	semWaitReport(role);
+
 	printf("%s: Exiting...\n", ((role == 0) ? "PARENT" : " CHILD"));
 	fflush(stdout);
 
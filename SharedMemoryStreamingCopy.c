@@ -0,0 +1,741 @@
+/* ============================================================================ **
+ **                           Embedded Linux                                     **
+ ** ============================================================================ **
+ **               +++++++++++++++++++++++++++++++++++++++                        **
+ **    Module:    +     SharedMemoryStreamingCopy.c     +                        **
+ **               +++++++++++++++++++++++++++++++++++++++                        **
+ **                                                                              **
+ **  Description: This module implements two process shared memory system        **
+ **               with Wait-Signal synchronization and large payload transfer:   **
+ **               non-temporal stores (producer) and software prefetch           **
+ **               (consumer) selected at runtime by CPU feature detection        **
+ **                                                                              **
+ ** ============================================================================ **
+ **         Edit                                      Data           Author      **
+ **    First release                                18/10/2026     F.Coppo       **
+ ** ============================================================================ */
+
+// Include .
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <sys/shm.h>
+#include <errno.h>
+#include <sys/wait.h>
+#include <stdbool.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <sys/sem.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define STREAM_X86
+#endif
+
+// Define .
+#define PAYLOAD_SIZE         (8*1024*1024)
+#define PAYLOAD_ITEMS        (PAYLOAD_SIZE / sizeof(long long))
+#define STREAM_THRESHOLD     (256*1024)
+#define PREFETCH_DISTANCE    1024
+#define CACHE_LINE           64
+#define LINE_ITEMS           (CACHE_LINE / sizeof(long long))
+#define OFFSET               65000
+#define SHARED_MEM_ID        111
+#define SEM_ID_1             112
+#define SEM_ID_2             113
+#define CYCLE_NUMBER         50
+#define PASS_MAX             8
+#define NSEC_PER_SEC         1000000000LL
+#define NSEC_PER_MS          1000000LL
+#define STALL_THRESHOLD_MS   500
+
+// Payload routines: producer fill and consumer copy .
+typedef void (* payloadFill_t) (long long * dst, size_t items, long long base);
+typedef void (* payloadCopy_t) (long long * dst, const long long * src, size_t items);
+
+// Local variables .
+static int childPid = 0;
+static int peerPid = 0;
+static int ipcShmid = -1;
+static int ipcSemid[2] = { -1, -1 };
+static unsigned int blockedCount = 0;
+static unsigned int stallCount = 0;
+static long long waitMaxNs = 0;
+static payloadFill_t streamFill;
+static payloadCopy_t streamCopy;
+static const char * streamName;
+
+// Callback linked to SIGINT signal .
+void endProcessesSignaller (int sig_num)
+{
+	if (childPid == 0)
+	{
+		// Child kill request .
+		printf("Child kill request (pid %d)\n", (int) getpid());
+		printf("Child killing...\n");
+		kill(getpid(), SIGUSR1);
+	}
+	else
+	{
+		// Father kill request: also the child is killed .
+		printf("Father kill request (pid %d)\n", (int) getpid());
+		printf("Child killing...\n");
+		kill(childPid, SIGUSR1);
+		printf("Father killing...\n");
+		kill(getpid(), SIGUSR1);
+	}
+}
+
+// Monotonic time in nanoseconds .
+static long long timeNowNs (void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (long long) ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+// Scalar fill (small payloads and fallback) .
+static void scalarFill (long long * dst, size_t items, long long base)
+{
+	size_t i;
+
+	for (i=0; i < items; i++)
+	{
+		dst[i] = base + (long long) i;
+	}
+}
+
+// Scalar copy (small payloads and fallback) .
+static void scalarCopy (long long * dst, const long long * src, size_t items)
+{
+	size_t i;
+
+	for (i=0; i < items; i++)
+	{
+		dst[i] = src[i];
+	}
+}
+
+#ifdef STREAM_X86
+// SSE2 fill: 16 bytes non-temporal stores bypass the producer cache .
+static void sse2StreamFill (long long * dst, size_t items, long long base)
+{
+	size_t i = 0;
+	__m128i value, step;
+
+	// Head up to 16 bytes alignment .
+	while ((i < items) && (((uintptr_t) &dst[i] & 15) != 0))
+	{
+		dst[i] = base + (long long) i;
+		i++;
+	}
+
+	value = _mm_set_epi64x(base + (long long) i + 1, base + (long long) i);
+	step = _mm_set1_epi64x(2);
+
+	for (; i + 2 <= items; i += 2)
+	{
+		_mm_stream_si128((__m128i *) &dst[i], value);
+		value = _mm_add_epi64(value, step);
+	}
+
+	// Tail .
+	for (; i < items; i++)
+	{
+		dst[i] = base + (long long) i;
+	}
+
+	// Streaming stores are weakly ordered: make them visible before the signal .
+	_mm_sfence();
+}
+
+// SSE2 copy: one non-temporal prefetch per source line, ordinary stores (the consumer reads the copy back right away) .
+static void sse2PrefetchCopy (long long * dst, const long long * src, size_t items)
+{
+	const char * line;
+	size_t i = 0;
+
+	// Head up to the destination cache line (the source may be unaligned) .
+	while ((i < items) && (((uintptr_t) &dst[i] & (CACHE_LINE - 1)) != 0))
+	{
+		dst[i] = src[i];
+		i++;
+	}
+
+	for (; i + LINE_ITEMS <= items; i += LINE_ITEMS)
+	{
+		line = (const char *) &src[i];
+		_mm_prefetch(line + PREFETCH_DISTANCE, _MM_HINT_NTA);
+		_mm_store_si128((__m128i *) &dst[i],     _mm_loadu_si128((const __m128i *) line));
+		_mm_store_si128((__m128i *) &dst[i + 2], _mm_loadu_si128((const __m128i *) (line + 16)));
+		_mm_store_si128((__m128i *) &dst[i + 4], _mm_loadu_si128((const __m128i *) (line + 32)));
+		_mm_store_si128((__m128i *) &dst[i + 6], _mm_loadu_si128((const __m128i *) (line + 48)));
+	}
+
+	for (; i < items; i++)
+	{
+		dst[i] = src[i];
+	}
+}
+
+// AVX2 fill: 32 bytes non-temporal stores .
+__attribute__((target("avx2")))
+static void avx2StreamFill (long long * dst, size_t items, long long base)
+{
+	size_t i = 0;
+	__m256i value, step;
+
+	while ((i < items) && (((uintptr_t) &dst[i] & 31) != 0))
+	{
+		dst[i] = base + (long long) i;
+		i++;
+	}
+
+	value = _mm256_set_epi64x(base + (long long) i + 3, base + (long long) i + 2, base + (long long) i + 1, base + (long long) i);
+	step = _mm256_set1_epi64x(4);
+
+	for (; i + 4 <= items; i += 4)
+	{
+		_mm256_stream_si256((__m256i *) &dst[i], value);
+		value = _mm256_add_epi64(value, step);
+	}
+
+	for (; i < items; i++)
+	{
+		dst[i] = base + (long long) i;
+	}
+
+	_mm_sfence();
+}
+
+// AVX2 copy: one non-temporal prefetch per source line, ordinary stores .
+__attribute__((target("avx2")))
+static void avx2PrefetchCopy (long long * dst, const long long * src, size_t items)
+{
+	const char * line;
+	size_t i = 0;
+
+	while ((i < items) && (((uintptr_t) &dst[i] & (CACHE_LINE - 1)) != 0))
+	{
+		dst[i] = src[i];
+		i++;
+	}
+
+	for (; i + LINE_ITEMS <= items; i += LINE_ITEMS)
+	{
+		line = (const char *) &src[i];
+		_mm_prefetch(line + PREFETCH_DISTANCE, _MM_HINT_NTA);
+		_mm256_store_si256((__m256i *) &dst[i],     _mm256_loadu_si256((const __m256i *) line));
+		_mm256_store_si256((__m256i *) &dst[i + 4], _mm256_loadu_si256((const __m256i *) (line + 32)));
+	}
+
+	for (; i < items; i++)
+	{
+		dst[i] = src[i];
+	}
+}
+#endif
+
+// Streaming routines selection (CPU feature detection at runtime) .
+static void streamSelect (bool forceScalar)
+{
+	streamFill = scalarFill;
+	streamCopy = scalarCopy;
+	streamName = "scalar";
+
+#ifdef STREAM_X86
+	if (!forceScalar)
+	{
+		__builtin_cpu_init();
+
+		if (__builtin_cpu_supports("avx2"))
+		{
+			streamFill = avx2StreamFill;
+			streamCopy = avx2PrefetchCopy;
+			streamName = "avx2";
+		}
+		else if (__builtin_cpu_supports("sse2"))
+		{
+			streamFill = sse2StreamFill;
+			streamCopy = sse2PrefetchCopy;
+			streamName = "sse2";
+		}
+	}
+#else
+	(void) forceScalar;
+#endif
+}
+
+// Payload write: streaming path above the threshold only .
+static void payloadWrite (long long * dst, size_t items, long long base)
+{
+	if (items * sizeof(long long) >= STREAM_THRESHOLD)
+	{
+		streamFill(dst, items, base);
+	}
+	else
+	{
+		scalarFill(dst, items, base);
+	}
+}
+
+// Payload read: streaming path above the threshold only .
+static void payloadRead (long long * dst, const long long * src, size_t items)
+{
+	if (items * sizeof(long long) >= STREAM_THRESHOLD)
+	{
+		streamCopy(dst, src, items);
+	}
+	else
+	{
+		scalarCopy(dst, src, items);
+	}
+}
+
+// Memory creation .
+static int sharedMemCreation (key_t key)
+{
+	struct shmid_ds shmds;
+
+	int shmid = shmget(key, PAYLOAD_SIZE, 0666 | IPC_CREAT);
+
+	if (shmid >= 0)
+	{
+		// Info request .
+		if (shmctl(shmid, IPC_STAT, &shmds) == 0)
+		{
+			printf("%d bytes size shared memory created\n", (int) shmds.shm_segsz);
+		}
+		else
+		{
+			printf("shmctl error = %d\n", errno);
+		}
+	}
+	else
+	{
+		printf("PARENT: shared memory segment not found.\n");
+		exit(-1);
+	}
+
+	return shmid;
+}
+
+// Memory context attaching .
+static bool sharedMemAttach (int shmid, int role, long long * * ptPtMem)
+{
+	struct shmid_ds shmds;
+	bool success = true;
+
+	// Attach shmid memory .
+	*ptPtMem = (long long *) shmat(shmid, (const void *)0, 0);
+
+	// Info request .
+	if ((*ptPtMem != (long long *) -1) && (shmctl(shmid, IPC_STAT, &shmds) == 0))
+	{
+		printf("%s: context attached (currently %d attaches)\n", ((role == 0) ? "PARENT" : " CHILD"), (int) shmds.shm_nattch);
+	}
+	else
+	{
+		printf("%s: shmctl error = %d\n",((role == 0) ? "PARENT" : " CHILD"), errno);
+		success = false;
+	}
+
+	return success;
+}
+
+// Memory context detaching .
+static void sharedMemDetaches(long long * ptMem, int shmid, int role)
+{
+	struct shmid_ds shmds;
+
+	if (shmdt(ptMem) == -1)
+	{
+		printf("%s: memory detaching error(%d)\n", ((role == 0) ? "PARENT" : " CHILD"), errno);
+	}
+	else
+	{
+		// Update info .
+		if(shmctl(shmid, IPC_STAT, &shmds) == 0)
+		{
+			printf("%s: memory (created by pid %d) detached (currently remaining %d attached)\n", ((role == 0) ? "PARENT" : " CHILD"), (int) shmds.shm_cpid, (int) shmds.shm_nattch);
+		}
+		else
+		{
+			printf("%s: shmctl error=%d\n", ((role == 0) ? "PARENT" : " CHILD"), errno);
+		}
+	}
+}
+
+// Binary semaphore creation .
+static int semCreate (key_t key)
+{
+	int semid;
+
+	semid = semget(key, 1, 0666 | IPC_CREAT );
+
+	if (semid != -1)
+	{
+		printf( "Semaphore %d has been created\n", semid);
+	}
+
+	return semid;
+}
+
+// Binary semaphore removing .
+static void semDelete (int semid)
+{
+	int res = semctl(semid, 0, IPC_RMID);
+
+	if (res != -1)
+	{
+		printf("Semaphore %d removed.\n", semid);
+	}
+}
+
+// Binary semaphore value setting .
+int semSetVal (int semid, int value)
+{
+	return semctl(semid, 0, SETVAL, value);
+}
+
+// Give-up path: the peer is dead, so nobody else will remove the IPC objects (the next run would find them) .
+static void ipcGiveUp (int role)
+{
+	int i;
+
+	if ((ipcShmid != -1) && (shmctl(ipcShmid, IPC_RMID, 0) == 0))
+	{
+		printf("%s: memory segment removed\n", ((role == 0) ? "PARENT" : " CHILD"));
+	}
+
+	for (i=0; i < 2; i++)
+	{
+		if (ipcSemid[i] != -1)
+		{
+			semDelete(ipcSemid[i]);
+		}
+	}
+
+	exit(-1);
+}
+
+// Binary semaphore acquire (bounded wait): every threshold spent blocked is reported with the holder (the peer) pid .
+void semWait (int semid, int role)
+{
+	struct sembuf sb;
+	struct timespec timeout;
+	long long start, waitedNs;
+	int res;
+
+	sb.sem_num = 0;
+	sb.sem_op = -1;
+	sb.sem_flg = IPC_NOWAIT;
+
+	// Fast path: same single semop as an unbounded wait .
+	if ( semop(semid, &sb, 1) == 0 )
+	{
+		return;
+	}
+
+	if ( errno != EAGAIN )
+	{
+		printf("%s: semaphore %d acquisition failed.\n", ((role == 0) ? "PARENT" : " CHILD"), semid);
+		exit(-1);
+	}
+
+	start = timeNowNs();
+	sb.sem_flg = 0;
+
+	timeout.tv_sec = (STALL_THRESHOLD_MS * NSEC_PER_MS) / NSEC_PER_SEC;
+	timeout.tv_nsec = (STALL_THRESHOLD_MS * NSEC_PER_MS) % NSEC_PER_SEC;
+
+	while ( ((res = semtimedop(semid, &sb, 1, &timeout)) == -1) && ((errno == EAGAIN) || (errno == EINTR)) )
+	{
+		if (errno != EAGAIN)
+		{
+			continue;
+		}
+
+		printf("%s: semaphore %d stalled for %lld ms (holder pid %d)\n", ((role == 0) ? "PARENT" : " CHILD"), semid, (timeNowNs() - start) / NSEC_PER_MS, peerPid);
+
+		// A dead peer (or an own child already exited) will never post .
+		if ((peerPid > 0) && (((kill(peerPid, 0) == -1) && (errno == ESRCH)) || (waitpid(peerPid, NULL, WNOHANG) == peerPid)))
+		{
+			printf("%s: semaphore %d holder (pid %d) is dead.\n", ((role == 0) ? "PARENT" : " CHILD"), semid, peerPid);
+			ipcGiveUp(role);
+		}
+	}
+
+	if ( res == -1 )
+	{
+		printf("%s: semaphore %d acquisition failed.\n", ((role == 0) ? "PARENT" : " CHILD"), semid);
+		exit(-1);
+	}
+
+	// Wait statistics (blocked waits only) .
+	waitedNs = timeNowNs() - start;
+	blockedCount++;
+
+	if (waitedNs > waitMaxNs)
+	{
+		waitMaxNs = waitedNs;
+	}
+
+	if (waitedNs >= STALL_THRESHOLD_MS * NSEC_PER_MS)
+	{
+		stallCount++;
+		printf("%s: semaphore %d wait took %lld ms (threshold %d ms)\n", ((role == 0) ? "PARENT" : " CHILD"), semid, waitedNs / NSEC_PER_MS, STALL_THRESHOLD_MS);
+	}
+}
+
+// Binary semaphore release .
+void semSignal(int semid, int role)
+{
+	struct sembuf sb;
+
+	sb.sem_num = 0;
+	sb.sem_op = 1;
+	sb.sem_flg = 0;
+
+	if ( semop(semid, &sb, 1) == -1 )
+	{
+		printf("%s: semaphore %d acquisition failed.\n", ((role == 0) ? "PARENT" : " CHILD"), semid);
+		exit(-1);
+	}
+}
+
+// Main routine: usage SharedMemoryStreamingCopy [scalar|stream]... (one pass per argument, e.g. "scalar stream" compares both) .
+int main(int argc, char * argv[])
+{
+	bool passScalar[PASS_MAX];
+	int passCount = 0;
+	int pass, arg;
+	long long * tmpBuff = NULL;
+	int shmid, retFork, status;
+	size_t i;
+	long long * mem = NULL;
+	int role = -1;
+	int semid1;
+	int semid2;
+	unsigned int cycle = CYCLE_NUMBER;
+	long long start, elapsedNs;
+
+	// Passes selection: scalar routines or the best streaming routines the CPU supports, streaming when no argument .
+	for (arg=1; (arg < argc) && (passCount < PASS_MAX); arg++)
+	{
+		if (strcmp(argv[arg], "scalar") == 0)
+		{
+			passScalar[passCount++] = true;
+		}
+		else if (strcmp(argv[arg], "stream") == 0)
+		{
+			passScalar[passCount++] = false;
+		}
+		else
+		{
+			printf("Unknown pass %s (expected: scalar or stream)\n", argv[arg]);
+			exit(-1);
+		}
+	}
+
+	if (passCount == 0)
+	{
+		passScalar[passCount++] = false;
+	}
+
+	printf("Payload %d bytes, streaming threshold %d bytes (%s), %d pass(es)\n", PAYLOAD_SIZE, STREAM_THRESHOLD,
+	       (PAYLOAD_SIZE >= STREAM_THRESHOLD) ? "streaming" : "cached", passCount);
+
+	// Signal callback registration .
+	signal(SIGINT, endProcessesSignaller);
+
+	// Shared memory create .
+	shmid = sharedMemCreation(SHARED_MEM_ID);
+
+	// Semaphore1 create .
+	semid1 = semCreate(SEM_ID_1);
+
+	// Semaphore 1 unlock (set value equal 1).
+	if (semid1 >= 0)
+	{
+		if (semSetVal(semid1, 1) != -1)
+		{
+			printf("Semaphore %d count = %d.\n", semid1, semctl(semid1, 0, GETVAL));
+		}
+	}
+	else
+	{
+		printf("Semaphore creation error\n");
+		exit(-1);
+	}
+
+	// Semaphore 2 create (leave value equal 0).
+	semid2 = semCreate(SEM_ID_2);
+
+	// Semaphore unlock .
+	if (semid2 >= 0)
+	{
+		printf("Semaphore %d count = %d.\n", semid2, semctl( semid2, 0, GETVAL ));
+	}
+	else
+	{
+		printf("Semaphore creation error\n");
+		exit(-1);
+	}
+
+	ipcShmid = shmid;
+	ipcSemid[0] = semid1;
+	ipcSemid[1] = semid2;
+
+	// Child creation .
+	fflush(stdout);
+	retFork = fork();
+
+	// Child pid update .
+	if (retFork > 0)
+	{
+		childPid = retFork;
+		peerPid = retFork;
+	}
+	else if (retFork == 0)
+	{
+		peerPid = getppid();
+	}
+
+	// Father .
+	if (retFork > 0)
+	{
+		printf("PARENT: process created (pid %d)\n", (int) getpid());
+
+		role = 0;
+
+		// Keep the context .
+		if ( sharedMemAttach(shmid, role, &mem) )
+		{
+			for (pass=0; pass < passCount; pass++)
+			{
+				streamSelect(passScalar[pass]);
+				cycle = CYCLE_NUMBER;
+				start = timeNowNs();
+
+				// Father cyclic write .
+				while(cycle--)
+				{
+					// Acquire semaphore .
+					semWait(semid1, role);
+
+					// Start of critical section .
+					payloadWrite(mem, PAYLOAD_ITEMS, (long long) cycle + OFFSET);
+					// End of critical section .
+
+					// Release semaphore .
+					semSignal(semid2, role);
+				}
+
+				elapsedNs = timeNowNs() - start;
+				printf("PARENT: %s pass, %d payloads written, %lld MB/s\n", streamName, CYCLE_NUMBER, ((long long) PAYLOAD_SIZE * CYCLE_NUMBER * 1000) / elapsedNs);
+			}
+		}
+
+		// Wait child ending before delete memory .
+		retFork = wait(&status);
+
+		// Detaching memory .
+		sharedMemDetaches(mem, shmid, role);
+
+		// Removing memory .
+		if (shmctl( shmid, IPC_RMID, 0 ) == 0)
+		{
+			printf( "PARENT: memory segment removed\n");
+		}
+		else
+		{
+			printf( "PARENT: memory segment removing fail!\n" );
+		}
+
+		// Semaphores delete .
+		semDelete(semid1);
+		semDelete(semid2);
+	}
+	else if (retFork == 0)
+	{
+		// Child .
+		unsigned int errors = 0;
+
+		role = 1;
+
+		printf(" CHILD: child process created (pid %d)\n", getpid());
+
+		// Receive buffer (cache line aligned for the streaming copy) .
+		tmpBuff = (long long *) aligned_alloc(64, PAYLOAD_SIZE);
+
+		if (tmpBuff == NULL)
+		{
+			printf(" CHILD: receive buffer allocation failed\n");
+			exit(-1);
+		}
+
+		// Keep identifier of the shared memory segment .
+		shmid = shmget(SHARED_MEM_ID, 0, 0);
+
+		// Keep the context .
+		if ( sharedMemAttach(shmid, role, &mem) )
+		{
+			for (pass=0; pass < passCount; pass++)
+			{
+				streamSelect(passScalar[pass]);
+				cycle = CYCLE_NUMBER;
+				errors = 0;
+				start = timeNowNs();
+
+				// Reading loop .
+				while(cycle--)
+				{
+					// Acquire semaphore .
+					semWait(semid2, role);
+
+					// Start of critical section .
+					payloadRead(tmpBuff, mem, PAYLOAD_ITEMS);
+					// End of critical section .
+
+					// Release semaphore .
+					semSignal(semid1, role);
+
+					// Values pattern control (out from critical section) .
+					for (i=0; i < PAYLOAD_ITEMS; i++)
+					{
+						// Check wrong read (child know the sequence) .
+						if (tmpBuff[i] != (long long) cycle + OFFSET + (long long) i)
+						{
+							printf(" CHILD: sequence error at item %u (expected value : %lld, read value : %lld)\n", (u_int) i, (long long) cycle + OFFSET + (long long) i, tmpBuff[i]);
+							errors++;
+							break;
+						}
+					}
+				}
+
+				elapsedNs = timeNowNs() - start;
+				printf(" CHILD: %s pass, %d payloads read, %lld MB/s (check included), %u sequence errors\n", streamName, CYCLE_NUMBER, ((long long) PAYLOAD_SIZE * CYCLE_NUMBER * 1000) / elapsedNs, errors);
+			}
+		}
+
+		// Memory detach .
+		sharedMemDetaches(mem, shmid, role);
+
+		free(tmpBuff);
+	}
+	else
+	{
+		printf("CHILD: error trying to fork() (%d)\n", errno);
+	}
+
+	printf("%s: %u blocked semaphore waits, max %lld us, %u over %d ms\n", ((role == 0) ? "PARENT" : " CHILD"), blockedCount, waitMaxNs / 1000, stallCount, STALL_THRESHOLD_MS);
+	printf("%s: Exiting...\n", ((role == 0) ? "PARENT" : " CHILD"));
+	fflush(stdout);
+
+	return 0;
+}
@@ -0,0 +1,745 @@
+/* ============================================================================ **
+ **                           Embedded Linux                                     **
+ ** ============================================================================ **
+ **             +++++++++++++++++++++++++++++++++++++++++++                      **
+ **    Module:  +    SharedMemoryThreadsOrProcesses.c     +                      **
+ **             +++++++++++++++++++++++++++++++++++++++++++                      **
+ **                                                                              **
+ **  Description: This module runs the same producer/consumer channel code as    **
+ **               forked processes or as threads of one process, with Unix       **
+ **               system V semaphores or process shared pthread objects, to      **
+ **               split the process boundary cost from the synchronization cost  **
+ **                                                                              **
+ ** ============================================================================ **
+ **         Edit                                      Data           Author      **
+ **    First release                                18/10/2026     F.Coppo       **
+ ** ============================================================================ */
+
+// Include .
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <sys/shm.h>
+#include <errno.h>
+#include <sys/wait.h>
+#include <stdbool.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <sys/sem.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+// Define .
+#define SHARED_MEM_ID          111
+#define SEM_ID_EMPTY           112
+#define SEM_ID_FULL            113
+#define MSG_ITEMS              16
+#define OFFSET                 65000
+#define CHANNEL_SLOTS          64
+#define MESSAGE_NUMBER         100000
+#define NSEC_PER_SEC 1000000000LL
+#define NSEC_PER_MS     1000000LL
+#define STALL_THRESHOLD_MS     500
+
+// Execution mode .
+typedef enum
+{
+	EXEC_PROCESS = 0,
+	EXEC_THREAD
+} execMode_t;
+
+// Synchronization backend .
+typedef enum
+{
+	SYNC_SYSV = 0,
+	SYNC_PTHREAD
+} syncBackend_t;
+
+// Process shared counting semaphore (mutex + condition variable) .
+typedef struct
+{
+	pthread_mutex_t mutex;
+	pthread_cond_t  cond;
+	int             count;
+} pthreadSem_t;
+
+// Message .
+typedef struct
+{
+	long long seq;
+	long long data[MSG_ITEMS];
+} message_t;
+
+// Shared memory layout: channel synchronization, ring and consumer results .
+typedef struct
+{
+	pthreadSem_t empty;
+	pthreadSem_t full;
+	unsigned int head;
+	unsigned int tail;
+	long long    consumerNs;
+	long long    consumerErrors;
+	message_t    slot[CHANNEL_SLOTS];
+} channel_t;
+
+// Backend independent semaphore handle .
+typedef struct
+{
+	syncBackend_t  backend;
+	int            semid;
+	pthreadSem_t * ptSem;
+} syncSem_t;
+
+// One side of the channel (producer or consumer) .
+typedef struct
+{
+	channel_t * ch;
+	syncSem_t   empty;
+	syncSem_t   full;
+	int         role;
+} endpoint_t;
+
+// Local variables .
+static int childPid = 0;
+static int peerPid = 0;
+static int ipcShmid = -1;
+static int ipcSemid[2] = { -1, -1 };
+
+// Wait statistics per role (producer and consumer may be threads of one process) .
+static unsigned int blockedCount[2] = { 0, 0 };
+static unsigned int stallCount[2] = { 0, 0 };
+static long long waitMaxNs[2] = { 0, 0 };
+
+// Callback linked to SIGINT signal .
+void endProcessesSignaller (int sig_num)
+{
+	if (childPid == 0)
+	{
+		// Child kill request .
+		printf("Child kill request (pid %d)\n", (int) getpid());
+		printf("Child killing...\n");
+		kill(getpid(), SIGUSR1);
+	}
+	else
+	{
+		// Father kill request: also the child is killed .
+		printf("Father kill request (pid %d)\n", (int) getpid());
+		printf("Child killing...\n");
+		kill(childPid, SIGUSR1);
+		printf("Father killing...\n");
+		kill(getpid(), SIGUSR1);
+	}
+}
+
+// Monotonic time in nanoseconds .
+static long long timeNowNs (void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (long long) ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+// Memory creation .
+static int sharedMemCreation (key_t key)
+{
+	struct shmid_ds shmds;
+
+	int shmid = shmget(key, sizeof(channel_t), 0666 | IPC_CREAT);
+
+	if (shmid >= 0)
+	{
+		// Info request .
+		if (shmctl(shmid, IPC_STAT, &shmds) == 0)
+		{
+			printf("%d bytes size shared memory created\n", (int) shmds.shm_segsz);
+		}
+		else
+		{
+			printf("shmctl error = %d\n", errno);
+		}
+	}
+	else
+	{
+		printf("PARENT: shared memory segment not found.\n");
+		exit(-1);
+	}
+
+	return shmid;
+}
+
+// Memory context attaching .
+static bool sharedMemAttach (int shmid, int role, channel_t * * ptPtMem)
+{
+	struct shmid_ds shmds;
+	bool success = true;
+
+	// Attach shmid memory .
+	*ptPtMem = (channel_t *) shmat(shmid, (const void *)0, 0);
+
+	// Info request .
+	if ((*ptPtMem != (channel_t *) -1) && (shmctl(shmid, IPC_STAT, &shmds) == 0))
+	{
+		printf("%s: context attached (currently %d attaches)\n", ((role == 0) ? "PARENT" : " CHILD"), (int) shmds.shm_nattch);
+	}
+	else
+	{
+		printf("%s: shmctl error = %d\n",((role == 0) ? "PARENT" : " CHILD"), errno);
+		success = false;
+	}
+
+	return success;
+}
+
+// Memory context detaching .
+static void sharedMemDetaches(channel_t * ptMem, int shmid, int role)
+{
+	struct shmid_ds shmds;
+
+	if (shmdt(ptMem) == -1)
+	{
+		printf("%s: memory detaching error(%d)\n", ((role == 0) ? "PARENT" : " CHILD"), errno);
+	}
+	else
+	{
+		// Update info .
+		if(shmctl(shmid, IPC_STAT, &shmds) == 0)
+		{
+			printf("%s: memory (created by pid %d) detached (currently remaining %d attached)\n", ((role == 0) ? "PARENT" : " CHILD"), (int) shmds.shm_cpid, (int) shmds.shm_nattch);
+		}
+		else
+		{
+			printf("%s: shmctl error=%d\n", ((role == 0) ? "PARENT" : " CHILD"), errno);
+		}
+	}
+}
+
+// Absolute deadline one stall threshold from now on the given clock .
+static void deadlineSet (struct timespec * ts, clockid_t clock)
+{
+	long long deadlineNs;
+
+	clock_gettime(clock, ts);
+
+	deadlineNs = (long long) ts->tv_sec * NSEC_PER_SEC + ts->tv_nsec + STALL_THRESHOLD_MS * NSEC_PER_MS;
+	ts->tv_sec = deadlineNs / NSEC_PER_SEC;
+	ts->tv_nsec = deadlineNs % NSEC_PER_SEC;
+}
+
+// Give-up path: the peer is dead, so nobody else will remove the IPC objects (the next run would find them) .
+static void ipcGiveUp (int role)
+{
+	int i;
+
+	if ((ipcShmid != -1) && (shmctl(ipcShmid, IPC_RMID, 0) == 0))
+	{
+		printf("%s: memory segment removed\n", ((role == 0) ? "PARENT" : " CHILD"));
+	}
+
+	for (i=0; i < 2; i++)
+	{
+		if ((ipcSemid[i] != -1) && (semctl(ipcSemid[i], 0, IPC_RMID) != -1))
+		{
+			printf("%s: semaphore %d removed\n", ((role == 0) ? "PARENT" : " CHILD"), ipcSemid[i]);
+		}
+	}
+
+	exit(-1);
+}
+
+// Still blocked after one more threshold: report, give up when the peer process is dead (threads have no peer pid) .
+static void waitStalled (const char * name, long long start, int role)
+{
+	printf("%s: %s stalled for %lld ms (holder pid %d)\n", ((role == 0) ? "PARENT" : " CHILD"), name, (timeNowNs() - start) / NSEC_PER_MS, (peerPid > 0) ? peerPid : (int) getpid());
+
+	if ((peerPid > 0) && (((kill(peerPid, 0) == -1) && (errno == ESRCH)) || (waitpid(peerPid, NULL, WNOHANG) == peerPid)))
+	{
+		printf("%s: %s holder (pid %d) is dead.\n", ((role == 0) ? "PARENT" : " CHILD"), name, peerPid);
+		ipcGiveUp(role);
+	}
+}
+
+// Wait statistics update for a wait that blocked, waits over the threshold are reported .
+static void waitRecord (const char * name, long long start, int role)
+{
+	long long waitedNs = timeNowNs() - start;
+
+	blockedCount[role]++;
+
+	if (waitedNs > waitMaxNs[role])
+	{
+		waitMaxNs[role] = waitedNs;
+	}
+
+	if (waitedNs >= STALL_THRESHOLD_MS * NSEC_PER_MS)
+	{
+		stallCount[role]++;
+		printf("%s: %s wait took %lld ms (threshold %d ms)\n", ((role == 0) ? "PARENT" : " CHILD"), name, waitedNs / NSEC_PER_MS, STALL_THRESHOLD_MS);
+	}
+}
+
+// Wait statistics report (and reset for the next run) .
+static void waitReport (int role)
+{
+	printf("%s: %u blocked waits, max %lld us, %u over %d ms\n", ((role == 0) ? "PARENT" : " CHILD"), blockedCount[role], waitMaxNs[role] / 1000, stallCount[role], STALL_THRESHOLD_MS);
+
+	blockedCount[role] = 0;
+	stallCount[role] = 0;
+	waitMaxNs[role] = 0;
+}
+
+// Robust mutex bounded lock: a mutex left locked by a dead process is recovered .
+// Returns the wait start time, 0 when the mutex was free (no clock read on the fast path) .
+static long long pthreadLock (pthread_mutex_t * ptMutex, int role)
+{
+	struct timespec deadline;
+	long long start = 0;
+	int res = pthread_mutex_trylock(ptMutex);
+
+	while ((res == EBUSY) || (res == ETIMEDOUT))
+	{
+		if (start == 0)
+		{
+			start = timeNowNs();
+		}
+		else
+		{
+			waitStalled("pthread mutex", start, role);
+		}
+
+		// Mutex timed lock works on the realtime clock only .
+		deadlineSet(&deadline, CLOCK_REALTIME);
+		res = pthread_mutex_timedlock(ptMutex, &deadline);
+	}
+
+	if (res == EOWNERDEAD)
+	{
+		printf("%s: mutex owner died, state recovered.\n", ((role == 0) ? "PARENT" : " CHILD"));
+		pthread_mutex_consistent(ptMutex);
+	}
+	else if (res != 0)
+	{
+		printf("%s: mutex lock failed (%d).\n", ((role == 0) ? "PARENT" : " CHILD"), res);
+		exit(-1);
+	}
+
+	return start;
+}
+
+// Process shared pthread semaphore initialization .
+static bool pthreadSemInit (pthreadSem_t * ptSem, int value)
+{
+	pthread_mutexattr_t mutexAttr;
+	pthread_condattr_t condAttr;
+	bool success = true;
+
+	pthread_mutexattr_init(&mutexAttr);
+	pthread_mutexattr_setpshared(&mutexAttr, PTHREAD_PROCESS_SHARED);
+	pthread_mutexattr_setrobust(&mutexAttr, PTHREAD_MUTEX_ROBUST);
+
+	pthread_condattr_init(&condAttr);
+	pthread_condattr_setpshared(&condAttr, PTHREAD_PROCESS_SHARED);
+	pthread_condattr_setclock(&condAttr, CLOCK_MONOTONIC);
+
+	if ((pthread_mutex_init(&ptSem->mutex, &mutexAttr) != 0) || (pthread_cond_init(&ptSem->cond, &condAttr) != 0))
+	{
+		success = false;
+	}
+
+	ptSem->count = value;
+
+	pthread_condattr_destroy(&condAttr);
+	pthread_mutexattr_destroy(&mutexAttr);
+
+	return success;
+}
+
+// Semaphore creation (value is the initial count) .
+static bool semCreate (syncSem_t * ptSync, syncBackend_t backend, key_t key, pthreadSem_t * ptSem, int value)
+{
+	bool success = false;
+
+	ptSync->backend = backend;
+	ptSync->semid = -1;
+	ptSync->ptSem = ptSem;
+
+	if (backend == SYNC_SYSV)
+	{
+		ptSync->semid = semget(key, 1, 0666 | IPC_CREAT );
+
+		if ((ptSync->semid != -1) && (semctl(ptSync->semid, 0, SETVAL, value) != -1))
+		{
+			success = true;
+		}
+	}
+	else
+	{
+		success = pthreadSemInit(ptSem, value);
+	}
+
+	return success;
+}
+
+// Semaphore removing .
+static void semDelete (syncSem_t * ptSync)
+{
+	if (ptSync->backend == SYNC_SYSV)
+	{
+		semctl(ptSync->semid, 0, IPC_RMID);
+	}
+	else
+	{
+		pthread_cond_destroy(&ptSync->ptSem->cond);
+		pthread_mutex_destroy(&ptSync->ptSem->mutex);
+	}
+}
+
+// System V semaphore operation: a decrement that would block becomes a bounded wait .
+static void semOperation (int semid, int op, int role)
+{
+	struct sembuf sb;
+	struct timespec timeout;
+	long long start;
+	int res;
+
+	sb.sem_num = 0;
+	sb.sem_op = op;
+	sb.sem_flg = (op < 0) ? IPC_NOWAIT : 0;
+
+	// Fast path: same single semop as an unbounded wait .
+	if ( semop(semid, &sb, 1) == 0 )
+	{
+		return;
+	}
+
+	if ( (op >= 0) || (errno != EAGAIN) )
+	{
+		printf("%s: semaphore %d operation failed.\n", ((role == 0) ? "PARENT" : " CHILD"), semid);
+		exit(-1);
+	}
+
+	start = timeNowNs();
+	sb.sem_flg = 0;
+
+	timeout.tv_sec = (STALL_THRESHOLD_MS * NSEC_PER_MS) / NSEC_PER_SEC;
+	timeout.tv_nsec = (STALL_THRESHOLD_MS * NSEC_PER_MS) % NSEC_PER_SEC;
+
+	while ( ((res = semtimedop(semid, &sb, 1, &timeout)) == -1) && ((errno == EAGAIN) || (errno == EINTR)) )
+	{
+		if (errno == EAGAIN)
+		{
+			waitStalled("semaphore", start, role);
+		}
+	}
+
+	if ( res == -1 )
+	{
+		printf("%s: semaphore %d operation failed.\n", ((role == 0) ? "PARENT" : " CHILD"), semid);
+		exit(-1);
+	}
+
+	waitRecord("semaphore", start, role);
+}
+
+// Wait (count decrement, blocking while zero) .
+void semWait (syncSem_t * ptSync, int role)
+{
+	if (ptSync->backend == SYNC_SYSV)
+	{
+		semOperation(ptSync->semid, -1, role);
+	}
+	else
+	{
+		pthreadSem_t * ptSem = ptSync->ptSem;
+		struct timespec deadline;
+		long long start = pthreadLock(&ptSem->mutex, role);
+		int res;
+
+		while (ptSem->count == 0)
+		{
+			if (start == 0)
+			{
+				start = timeNowNs();
+			}
+
+			// Condition variable clock is monotonic (see pthreadSemInit) .
+			deadlineSet(&deadline, CLOCK_MONOTONIC);
+			res = pthread_cond_timedwait(&ptSem->cond, &ptSem->mutex, &deadline);
+
+			if (res == EOWNERDEAD)
+			{
+				printf("%s: mutex owner died, state recovered.\n", ((role == 0) ? "PARENT" : " CHILD"));
+				pthread_mutex_consistent(&ptSem->mutex);
+			}
+			else if ((res == ETIMEDOUT) && (ptSem->count == 0))
+			{
+				waitStalled("pthread semaphore", start, role);
+			}
+		}
+
+		if (start != 0)
+		{
+			waitRecord("pthread semaphore", start, role);
+		}
+
+		ptSem->count--;
+
+		pthread_mutex_unlock(&ptSem->mutex);
+	}
+}
+
+// Signal (count increment, wake up one waiter) .
+void semSignal (syncSem_t * ptSync, int role)
+{
+	if (ptSync->backend == SYNC_SYSV)
+	{
+		semOperation(ptSync->semid, 1, role);
+	}
+	else
+	{
+		pthreadSem_t * ptSem = ptSync->ptSem;
+
+		pthreadLock(&ptSem->mutex, role);
+		ptSem->count++;
+		pthread_cond_signal(&ptSem->cond);
+		pthread_mutex_unlock(&ptSem->mutex);
+	}
+}
+
+// Endpoint setup on a given mapping (pthread objects are addressed through it) .
+static void endpointInit (endpoint_t * ep, channel_t * ch, const syncSem_t * empty, const syncSem_t * full, int role)
+{
+	ep->ch = ch;
+	ep->empty = *empty;
+	ep->full = *full;
+	ep->empty.ptSem = &ch->empty;
+	ep->full.ptSem = &ch->full;
+	ep->role = role;
+}
+
+// Producer: same code for both execution modes .
+static void * producerRun (void * arg)
+{
+	endpoint_t * ep = (endpoint_t *) arg;
+	channel_t * ch = ep->ch;
+	message_t * slot;
+	long long seq;
+	int i;
+
+	for (seq=0; seq < MESSAGE_NUMBER; seq++)
+	{
+		semWait(&ep->empty, ep->role);
+
+		slot = &ch->slot[ch->head % CHANNEL_SLOTS];
+		slot->seq = seq;
+		for (i=0; i < MSG_ITEMS; i++)
+		{
+			slot->data[i] = seq + i + OFFSET;
+		}
+		ch->head++;
+
+		semSignal(&ep->full, ep->role);
+	}
+
+	waitReport(ep->role);
+
+	return NULL;
+}
+
+// Consumer: same code for both execution modes, results left in the channel .
+static void * consumerRun (void * arg)
+{
+	endpoint_t * ep = (endpoint_t *) arg;
+	channel_t * ch = ep->ch;
+	message_t msg;
+	long long seq, start = timeNowNs();
+	int i;
+
+	ch->consumerErrors = 0;
+
+	for (seq=0; seq < MESSAGE_NUMBER; seq++)
+	{
+		semWait(&ep->full, ep->role);
+
+		msg = ch->slot[ch->tail % CHANNEL_SLOTS];
+		ch->tail++;
+
+		semSignal(&ep->empty, ep->role);
+
+		// Values pattern control (out from critical section) .
+		for (i=0; i < MSG_ITEMS; i++)
+		{
+			if ((msg.seq != seq) || (msg.data[i] != seq + i + OFFSET))
+			{
+				ch->consumerErrors++;
+				break;
+			}
+		}
+	}
+
+	ch->consumerNs = timeNowNs() - start;
+
+	waitReport(ep->role);
+
+	return NULL;
+}
+
+// One complete run: total time from the start of the consumer to its end .
+static void runMode (execMode_t mode, syncBackend_t backend)
+{
+	const char * name = (mode == EXEC_PROCESS) ? "process" : "thread";
+	const char * syncName = (backend == SYNC_SYSV) ? "sysv" : "pthread";
+	int shmid, retFork, status;
+	channel_t * ch = NULL;
+	syncSem_t empty, full;
+	endpoint_t producer, consumer;
+	pthread_t thread;
+	long long start, totalNs;
+
+	// Shared memory create .
+	shmid = sharedMemCreation(SHARED_MEM_ID);
+
+	if (!sharedMemAttach(shmid, 0, &ch))
+	{
+		exit(-1);
+	}
+
+	memset(ch, 0, sizeof(channel_t));
+
+	// EMPTY counts free slots, FULL counts ready messages .
+	if (!semCreate(&empty, backend, SEM_ID_EMPTY, &ch->empty, CHANNEL_SLOTS) ||
+	    !semCreate(&full, backend, SEM_ID_FULL, &ch->full, 0))
+	{
+		printf("Semaphore creation error\n");
+		exit(-1);
+	}
+
+	ipcShmid = shmid;
+	ipcSemid[0] = empty.semid;
+	ipcSemid[1] = full.semid;
+	peerPid = 0;
+
+	endpointInit(&producer, ch, &empty, &full, 0);
+
+	fflush(stdout);
+	start = timeNowNs();
+
+	if (mode == EXEC_PROCESS)
+	{
+		// Consumer as child process with its own mapping .
+		retFork = fork();
+
+		if (retFork == 0)
+		{
+			channel_t * childCh = NULL;
+
+			peerPid = getppid();
+			shmid = shmget(SHARED_MEM_ID, 0, 0);
+
+			if (sharedMemAttach(shmid, 1, &childCh))
+			{
+				endpointInit(&consumer, childCh, &empty, &full, 1);
+				consumerRun(&consumer);
+				sharedMemDetaches(childCh, shmid, 1);
+			}
+
+			fflush(stdout);
+			exit(0);
+		}
+		else if (retFork > 0)
+		{
+			childPid = retFork;
+			peerPid = retFork;
+
+			producerRun(&producer);
+
+			retFork = wait(&status);
+			childPid = 0;
+			peerPid = 0;
+		}
+		else
+		{
+			printf("PARENT: error trying to fork() (%d)\n", errno);
+		}
+	}
+	else
+	{
+		// Consumer as thread on the same mapping .
+		endpointInit(&consumer, ch, &empty, &full, 1);
+
+		if (pthread_create(&thread, NULL, consumerRun, &consumer) == 0)
+		{
+			producerRun(&producer);
+			pthread_join(thread, NULL);
+		}
+		else
+		{
+			printf("PARENT: error trying to create the thread\n");
+		}
+	}
+
+	totalNs = timeNowNs() - start;
+
+	printf("RESULT: %-7s %-7s %6lld ns/msg transfer, %6lld ns/msg including start-up, %lld errors\n",
+	       name, syncName, ch->consumerNs / MESSAGE_NUMBER, totalNs / MESSAGE_NUMBER, ch->consumerErrors);
+
+	// Semaphores delete (pthread objects first, they live in the segment) .
+	semDelete(&empty);
+	semDelete(&full);
+
+	// Detaching and removing memory .
+	sharedMemDetaches(ch, shmid, 0);
+
+	if (shmctl( shmid, IPC_RMID, 0 ) != 0)
+	{
+		printf( "PARENT: memory segment removing fail!\n" );
+	}
+}
+
+// Main routine: usage SharedMemoryThreadsOrProcesses [process|thread] [sysv|pthread] (all if omitted) .
+int main(int argc, char * argv[])
+{
+	bool runExec[2] = { true, true };
+	bool runSync[2] = { true, true };
+	int mode, sync, arg;
+
+	for (arg=1; arg < argc; arg++)
+	{
+		if ((strcmp(argv[arg], "process") == 0) || (strcmp(argv[arg], "thread") == 0))
+		{
+			runExec[EXEC_PROCESS] = (strcmp(argv[arg], "process") == 0);
+			runExec[EXEC_THREAD] = !runExec[EXEC_PROCESS];
+		}
+		else if ((strcmp(argv[arg], "sysv") == 0) || (strcmp(argv[arg], "pthread") == 0))
+		{
+			runSync[SYNC_SYSV] = (strcmp(argv[arg], "sysv") == 0);
+			runSync[SYNC_PTHREAD] = !runSync[SYNC_SYSV];
+		}
+		else
+		{
+			printf("Usage: %s [process|thread] [sysv|pthread]\n", argv[0]);
+			return -1;
+		}
+	}
+
+	// Signal callback registration .
+	signal(SIGINT, endProcessesSignaller);
+
+	for (mode=EXEC_PROCESS; mode <= EXEC_THREAD; mode++)
+	{
+		for (sync=SYNC_SYSV; sync <= SYNC_PTHREAD; sync++)
+		{
+			if (runExec[mode] && runSync[sync])
+			{
+				runMode((execMode_t) mode, (syncBackend_t) sync);
+			}
+		}
+	}
+
+	printf("PARENT: Exiting...\n");
+	fflush(stdout);
+
+	return 0;
+}
@@ -0,0 +1,204 @@
+/* ============================================================================ **
+ **                           Embedded Linux                                     **
+ ** ============================================================================ **
+ **             +++++++++++++++++++++++++++++++++++++++++++                      **
+ **    Module:  +    SharedMemoryTypedChannel.cpp         +                      **
+ **             +++++++++++++++++++++++++++++++++++++++++++                      **
+ **                                                                              **
+ **  Description: This module runs the producer/consumer test on the typed       **
+ **               channel template (SharedMemoryChannel.hpp): the same code is   **
+ **               instantiated once per synchronization policy                   **
+ **                                                                              **
+ ** ============================================================================ **
+ **         Edit                                      Data           Author      **
+ **    First release                                18/10/2026     F.Coppo       **
+ ** ============================================================================ */
+
+// Include .
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <csignal>
+#include <ctime>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "SharedMemoryChannel.hpp"
+
+// Define .
+#define SHARED_MEM_ID          111
+#define SEM_ID                 112
+#define BUFFER_SIZE            16
+#define OFFSET                 65000
+#define CHANNEL_SLOTS          64
+#define MESSAGE_NUMBER         100000
+#define NSEC_PER_SEC 1000000000LL
+
+// Message .
+typedef struct
+{
+	long long seq;
+	long long data[BUFFER_SIZE];
+} message_t;
+
+// Local variables .
+static int childPid = 0;
+
+// Callback linked to SIGINT signal .
+void endProcessesSignaller (int sig_num)
+{
+	if (childPid == 0)
+	{
+		// Child kill request .
+		printf("Child kill request (pid %d)\n", (int) getpid());
+		printf("Child killing...\n");
+		kill(getpid(), SIGUSR1);
+	}
+	else
+	{
+		// Father kill request: also the child is killed .
+		printf("Father kill request (pid %d)\n", (int) getpid());
+		printf("Child killing...\n");
+		kill(childPid, SIGUSR1);
+		printf("Father killing...\n");
+		kill(getpid(), SIGUSR1);
+	}
+}
+
+// Monotonic time in nanoseconds .
+static long long timeNowNs (void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (long long) ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+// Complete parent (producer) / child (consumer) run with one synchronization policy .
+template <typename SyncPolicy>
+static void runPolicy (void)
+{
+	shm::Channel<message_t, CHANNEL_SLOTS, SyncPolicy> channel;
+	message_t msg;
+	long long seq, start;
+	unsigned int errors = 0;
+	int role, retFork, status, i;
+
+	if (!channel.create(SHARED_MEM_ID, SEM_ID))
+	{
+		exit(-1);
+	}
+
+	// Child creation (the attached segment is inherited, pending output is flushed first) .
+	fflush(stdout);
+	retFork = fork();
+
+	if (retFork > 0)
+	{
+		childPid = retFork;
+		channel.peer(retFork);
+		role = 0;
+	}
+	else if (retFork == 0)
+	{
+		channel.peer(getppid());
+		role = 1;
+	}
+	else
+	{
+		printf("PARENT: error trying to fork() (%d)\n", errno);
+		exit(-1);
+	}
+
+	start = timeNowNs();
+
+	for (seq=0; seq < MESSAGE_NUMBER; seq++)
+	{
+		if (role == 0)
+		{
+			msg.seq = seq;
+			for (i=0; i < BUFFER_SIZE; i++)
+			{
+				msg.data[i] = seq + i + OFFSET;
+			}
+
+			if (!channel.send(msg))
+			{
+				// Dead peer: nobody else will remove the IPC objects .
+				printf("PARENT: send failed (%d)\n", errno);
+				channel.remove();
+				exit(-1);
+			}
+		}
+		else
+		{
+			if (!channel.receive(msg))
+			{
+				printf(" CHILD: receive failed (%d)\n", errno);
+				channel.remove();
+				exit(-1);
+			}
+
+			// Values pattern control .
+			for (i=0; i < BUFFER_SIZE; i++)
+			{
+				if ((msg.seq != seq) || (msg.data[i] != seq + i + OFFSET))
+				{
+					errors++;
+					break;
+				}
+			}
+		}
+	}
+
+	printf("%s: %-7s %d messages, %lld ns/message, %u sequence errors\n", ((role == 0) ? "PARENT" : " CHILD"), SyncPolicy::name, MESSAGE_NUMBER, (timeNowNs() - start) / MESSAGE_NUMBER, errors);
+
+	if (role == 0)
+	{
+		// Wait child ending before delete memory .
+		wait(&status);
+		channel.remove();
+		childPid = 0;
+	}
+	else
+	{
+		channel.detach();
+		fflush(stdout);
+		exit(0);
+	}
+}
+
+// Main routine: usage SharedMemoryTypedChannel [sysv|pthread|spin] (all if omitted) .
+int main(int argc, char * argv[])
+{
+	const char * policy = (argc > 1) ? argv[1] : "all";
+	bool all = (strcmp(policy, "all") == 0);
+
+	if (!all && (strcmp(policy, "sysv") != 0) && (strcmp(policy, "pthread") != 0) && (strcmp(policy, "spin") != 0))
+	{
+		printf("Usage: %s [sysv|pthread|spin]\n", argv[0]);
+		return -1;
+	}
+
+	// Signal callback registration .
+	signal(SIGINT, endProcessesSignaller);
+
+	if (all || (strcmp(policy, "sysv") == 0))
+	{
+		runPolicy<shm::SysVSync>();
+	}
+
+	if (all || (strcmp(policy, "pthread") == 0))
+	{
+		runPolicy<shm::PthreadSync>();
+	}
+
+	if (all || (strcmp(policy, "spin") == 0))
+	{
+		runPolicy<shm::SpinSync>();
+	}
+
+	printf("PARENT: Exiting...\n");
+
+	return 0;
+}
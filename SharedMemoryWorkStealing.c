@@ -0,0 +1,448 @@
+/* ============================================================================ **
+ **                           Embedded Linux                                     **
+ ** ============================================================================ **
+ **               +++++++++++++++++++++++++++++++++++++++                        **
+ **    Module:    +     SharedMemoryWorkStealing.c      +                        **
+ **               +++++++++++++++++++++++++++++++++++++++                        **
+ **                                                                              **
+ **  Description: This module implements a pool of forked worker processes with  **
+ **               one Chase-Lev work stealing deque each in the shared memory    **
+ **               segment: the owner pushes/pops at the bottom, idle workers     **
+ **               steal from the top of the others                               **
+ **                                                                              **
+ ** ============================================================================ **
+ **         Edit                                      Data           Author      **
+ **    First release                                18/10/2026     F.Coppo       **
+ ** ============================================================================ */
+
+// Include .
+#include <stdio.h>
+#include <sys/shm.h>
+#include <errno.h>
+#include <sys/wait.h>
+#include <stdbool.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <sched.h>
+#include <time.h>
+
+// Define .
+#define SHARED_MEM_ID          111
+#define WORKER_NUMBER          4
+#define DEQUE_SIZE             8192
+#define DEQUE_MASK             (DEQUE_SIZE - 1)
+#define TASK_PER_WORKER        500
+#define TASK_COST_BASE         2000
+#define TASK_COST_HEAVY        20
+#define TASK_SPLIT_COST        20000
+#define NSEC_PER_SEC 1000000000LL
+#define CACHE_LINE             64
+
+// Task: amount of work (loop iterations) .
+typedef struct
+{
+	long long cost;
+	long long id;
+} task_t;
+
+// Chase-Lev deque (fixed size) and worker counters .
+typedef struct
+{
+	_Atomic long      top;
+	char              pad1[CACHE_LINE - sizeof(long)];
+	_Atomic long      bottom;
+	char              pad2[CACHE_LINE - sizeof(long)];
+	task_t            task[DEQUE_SIZE];
+	long long         executed;
+	long long         stolen;
+	long long         stealFailed;
+	long long         work;
+	long long         elapsedNs;
+	int               pid;
+} __attribute__((aligned(CACHE_LINE))) deque_t;
+
+// Shared memory layout .
+typedef struct
+{
+	_Atomic long pending;
+	deque_t      deque[WORKER_NUMBER];
+} pool_t;
+
+// Local variables .
+static int childPid = 0;
+static volatile unsigned long long workSink;
+
+// Callback linked to SIGINT signal .
+void endProcessesSignaller (int sig_num)
+{
+	if (childPid == 0)
+	{
+		// Child kill request .
+		printf("Child kill request (pid %d)\n", (int) getpid());
+		printf("Child killing...\n");
+		kill(getpid(), SIGUSR1);
+	}
+	else
+	{
+		// Father kill request: the whole process group is killed .
+		printf("Father kill request (pid %d)\n", (int) getpid());
+		printf("Workers killing...\n");
+		kill(0, SIGUSR1);
+	}
+}
+
+// Monotonic time in nanoseconds .
+static long long timeNowNs (void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (long long) ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+// Owner push at the bottom (false when the deque is full) .
+static bool dequePush (deque_t * dq, const task_t * task)
+{
+	long b = atomic_load_explicit(&dq->bottom, memory_order_relaxed);
+	long t = atomic_load_explicit(&dq->top, memory_order_acquire);
+
+	if (b - t >= DEQUE_SIZE)
+	{
+		return false;
+	}
+
+	dq->task[b & DEQUE_MASK] = *task;
+	atomic_thread_fence(memory_order_release);
+	atomic_store_explicit(&dq->bottom, b + 1, memory_order_relaxed);
+
+	return true;
+}
+
+// Owner pop at the bottom (LIFO, races with the thieves only on the last task) .
+static bool dequePop (deque_t * dq, task_t * task)
+{
+	long b = atomic_load_explicit(&dq->bottom, memory_order_relaxed) - 1;
+	long t;
+	bool found = true;
+
+	atomic_store_explicit(&dq->bottom, b, memory_order_relaxed);
+	atomic_thread_fence(memory_order_seq_cst);
+	t = atomic_load_explicit(&dq->top, memory_order_relaxed);
+
+	if (t <= b)
+	{
+		*task = dq->task[b & DEQUE_MASK];
+
+		if (t == b)
+		{
+			// Last task: a thief could take it too .
+			if (!atomic_compare_exchange_strong_explicit(&dq->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed))
+			{
+				found = false;
+			}
+
+			atomic_store_explicit(&dq->bottom, b + 1, memory_order_relaxed);
+		}
+	}
+	else
+	{
+		// Empty .
+		found = false;
+		atomic_store_explicit(&dq->bottom, b + 1, memory_order_relaxed);
+	}
+
+	return found;
+}
+
+// Thief steal at the top (FIFO, the oldest and usually biggest task) .
+static bool dequeSteal (deque_t * dq, task_t * task)
+{
+	long t = atomic_load_explicit(&dq->top, memory_order_acquire);
+	long b;
+
+	atomic_thread_fence(memory_order_seq_cst);
+	b = atomic_load_explicit(&dq->bottom, memory_order_acquire);
+
+	if (t < b)
+	{
+		*task = dq->task[t & DEQUE_MASK];
+
+		if (atomic_compare_exchange_strong_explicit(&dq->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Task execution: big tasks are split and the halves pushed on the own deque .
+static void taskExecute (pool_t * pool, deque_t * own, task_t * task)
+{
+	long long i;
+	unsigned long long acc = (unsigned long long) task->id;
+	task_t half;
+
+	while (task->cost > TASK_SPLIT_COST)
+	{
+		half.cost = task->cost / 2;
+		half.id = task->id;
+
+		// Counted before it becomes visible: a thief may run it and decrement pending before the push returns .
+		atomic_fetch_add_explicit(&pool->pending, 1, memory_order_relaxed);
+
+		if (!dequePush(own, &half))
+		{
+			atomic_fetch_sub_explicit(&pool->pending, 1, memory_order_relaxed);
+			break;
+		}
+
+		task->cost -= half.cost;
+	}
+
+	// Linear congruential step: unsigned, the product wraps modulo 2^64 .
+	for (i=0; i < task->cost; i++)
+	{
+		acc = acc * 6364136223846793005ULL + 1442695040888963407ULL;
+	}
+
+	workSink = acc;
+
+	own->work += task->cost;
+	own->executed++;
+
+	atomic_fetch_sub_explicit(&pool->pending, 1, memory_order_release);
+}
+
+// Worker loop: own deque first, then steal, until no task is pending .
+static void workerRun (pool_t * pool, int worker, bool stealing)
+{
+	deque_t * own = &pool->deque[worker];
+	unsigned int seed = (unsigned int) getpid();
+	long long start = timeNowNs();
+	task_t task;
+	int victim;
+
+	own->pid = (int) getpid();
+
+	while (atomic_load_explicit(&pool->pending, memory_order_acquire) > 0)
+	{
+		if (dequePop(own, &task))
+		{
+			taskExecute(pool, own, &task);
+		}
+		else if (stealing)
+		{
+			victim = rand_r(&seed) % WORKER_NUMBER;
+
+			if ((victim != worker) && dequeSteal(&pool->deque[victim], &task))
+			{
+				own->stolen++;
+				taskExecute(pool, own, &task);
+			}
+			else
+			{
+				own->stealFailed++;
+				sched_yield();
+			}
+		}
+		else
+		{
+			// Static partitioning: the own deque is drained, nothing else to do .
+			break;
+		}
+	}
+
+	own->elapsedNs = timeNowNs() - start;
+}
+
+// Memory creation .
+static int sharedMemCreation (key_t key)
+{
+	struct shmid_ds shmds;
+
+	int shmid = shmget(key, sizeof(pool_t), 0666 | IPC_CREAT);
+
+	if (shmid >= 0)
+	{
+		// Info request .
+		if (shmctl(shmid, IPC_STAT, &shmds) == 0)
+		{
+			printf("%d bytes size shared memory created\n", (int) shmds.shm_segsz);
+		}
+		else
+		{
+			printf("shmctl error = %d\n", errno);
+		}
+	}
+	else
+	{
+		printf("PARENT: shared memory segment not found.\n");
+		exit(-1);
+	}
+
+	return shmid;
+}
+
+// Memory context attaching .
+static bool sharedMemAttach (int shmid, int role, pool_t * * ptPtMem)
+{
+	struct shmid_ds shmds;
+	bool success = true;
+
+	// Attach shmid memory .
+	*ptPtMem = (pool_t *) shmat(shmid, (const void *)0, 0);
+
+	// Info request .
+	if ((*ptPtMem != (pool_t *) -1) && (shmctl(shmid, IPC_STAT, &shmds) == 0))
+	{
+		printf("%s: context attached (currently %d attaches)\n", ((role == 0) ? "PARENT" : " CHILD"), (int) shmds.shm_nattch);
+	}
+	else
+	{
+		printf("%s: shmctl error = %d\n",((role == 0) ? "PARENT" : " CHILD"), errno);
+		success = false;
+	}
+
+	return success;
+}
+
+// Memory context detaching .
+static void sharedMemDetaches(pool_t * ptMem, int shmid, int role)
+{
+	struct shmid_ds shmds;
+
+	if (shmdt(ptMem) == -1)
+	{
+		printf("%s: memory detaching error(%d)\n", ((role == 0) ? "PARENT" : " CHILD"), errno);
+	}
+	else
+	{
+		// Update info .
+		if(shmctl(shmid, IPC_STAT, &shmds) == 0)
+		{
+			printf("%s: memory (created by pid %d) detached (currently remaining %d attached)\n", ((role == 0) ? "PARENT" : " CHILD"), (int) shmds.shm_cpid, (int) shmds.shm_nattch);
+		}
+		else
+		{
+			printf("%s: shmctl error=%d\n", ((role == 0) ? "PARENT" : " CHILD"), errno);
+		}
+	}
+}
+
+// Main routine: usage SharedMemoryWorkStealing [static] (no stealing, for comparison) .
+int main(int argc, char * argv[])
+{
+	int shmid, retFork, status, worker, i;
+	pool_t * pool = NULL;
+	int role = 0;
+	bool stealing = !((argc > 1) && (strcmp(argv[1], "static") == 0));
+	unsigned int seed = 1;
+	long long start, elapsed;
+	task_t task;
+
+	printf("%d workers, %d tasks each, %s\n", WORKER_NUMBER, TASK_PER_WORKER, stealing ? "work stealing" : "static partitioning");
+
+	// Signal callback registration .
+	signal(SIGINT, endProcessesSignaller);
+
+	// Shared memory create .
+	shmid = sharedMemCreation(SHARED_MEM_ID);
+
+	if (!sharedMemAttach(shmid, role, &pool))
+	{
+		exit(-1);
+	}
+
+	memset(pool, 0, sizeof(pool_t));
+
+	// Tasks distribution before the workers exist (the parent is the only owner): worker 0 gets the heavy ones .
+	for (worker=0; worker < WORKER_NUMBER; worker++)
+	{
+		for (i=0; i < TASK_PER_WORKER; i++)
+		{
+			task.id = (long long) worker * TASK_PER_WORKER + i;
+			task.cost = TASK_COST_BASE / 2 + rand_r(&seed) % TASK_COST_BASE;
+
+			if (worker == 0)
+			{
+				task.cost *= TASK_COST_HEAVY;
+			}
+
+			if (dequePush(&pool->deque[worker], &task))
+			{
+				atomic_fetch_add(&pool->pending, 1);
+			}
+		}
+	}
+
+	start = timeNowNs();
+
+	// Workers creation (the attached segment is inherited) .
+	for (worker=0; worker < WORKER_NUMBER; worker++)
+	{
+		fflush(stdout);
+		retFork = fork();
+
+		if (retFork == 0)
+		{
+			childPid = 0;
+
+			workerRun(pool, worker, stealing);
+
+			sharedMemDetaches(pool, shmid, 1);
+
+			fflush(stdout);
+			exit(0);
+		}
+		else if (retFork > 0)
+		{
+			childPid = retFork;
+		}
+		else
+		{
+			printf("PARENT: error trying to fork() (%d)\n", errno);
+		}
+	}
+
+	// Wait workers ending before delete memory .
+	while (wait(&status) > 0)
+	{
+	}
+
+	elapsed = timeNowNs() - start;
+
+	// Workers report .
+	printf("\n%-6s %7s %9s %7s %12s %13s %9s\n", "worker", "pid", "executed", "stolen", "steal fails", "work (Mloop)", "time (ms)");
+
+	for (worker=0; worker < WORKER_NUMBER; worker++)
+	{
+		deque_t * dq = &pool->deque[worker];
+
+		printf("%-6d %7d %9lld %7lld %12lld %13.1f %9lld\n", worker, dq->pid, dq->executed, dq->stolen, dq->stealFailed, (double) dq->work / 1e6, dq->elapsedNs / 1000000);
+	}
+
+	printf("\nPARENT: all tasks done in %lld ms (%ld pending)\n", elapsed / 1000000, atomic_load(&pool->pending));
+
+	// Detaching memory .
+	sharedMemDetaches(pool, shmid, role);
+
+	// Removing memory .
+	if (shmctl( shmid, IPC_RMID, 0 ) == 0)
+	{
+		printf( "PARENT: memory segment removed\n");
+	}
+	else
+	{
+		printf( "PARENT: memory segment removing fail!\n" );
+	}
+
+	printf("PARENT: Exiting...\n");
+	fflush(stdout);
+
+	return 0;
+}
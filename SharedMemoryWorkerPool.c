@@ -0,0 +1,709 @@
+/* ============================================================================ **
+ **                           Embedded Linux                                     **
+ ** ============================================================================ **
+ **               +++++++++++++++++++++++++++++++++++++++                        **
+ **    Module:    +     SharedMemoryWorkerPool.c        +                        **
+ **               +++++++++++++++++++++++++++++++++++++++                        **
+ **                                                                              **
+ **  Description: This module implements a supervisor keeping a pool of          **
+ **               pre-forked consumers, already attached to the shared memory    **
+ **               segment with page tables prefaulted, so a channel is assigned  **
+ **               without fork/attach/first touch cost; exited workers are       **
+ **               replaced in background and the cold start is measured too     **
+ **                                                                              **
+ ** ============================================================================ **
+ **         Edit                                      Data           Author      **
+ **    First release                                18/10/2026     F.Coppo       **
+ ** ============================================================================ */
+
+// Include .
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <sys/shm.h>
+#include <errno.h>
+#include <sys/wait.h>
+#include <stdbool.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <sys/sem.h>
+#include <sys/mman.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <sched.h>
+#include <time.h>
+
+// Define .
+#define SHARED_MEM_ID          111
+#define SEM_ID                 112
+#define POOL_SIZE              4
+#define SEM_DONE               POOL_SIZE
+#define CHANNEL_NUMBER         8
+#define CHANNEL_MB             4
+#define WORKER_JOBS            3
+#define BURST_SIZE             2
+#define BURST_NUMBER           16
+#define COLD_BURST_NUMBER      4
+#define OFFSET                 65000
+#define REAP_INTERVAL_MS       50
+#define STALL_THRESHOLD_MS     500
+#define NSEC_PER_MS     1000000LL
+#define NSEC_PER_SEC 1000000000LL
+#define CACHE_LINE             64
+
+// Worker state .
+typedef enum
+{
+	WORKER_STARTING = 0,
+	WORKER_READY,
+	WORKER_BUSY,
+	WORKER_EXITED
+} workerState_t;
+
+// Worker slot: assignment written by the supervisor, results by the worker .
+typedef struct
+{
+	_Atomic int state;
+	int         pid;
+	int         channel;
+	int         jobs;
+	long long   pattern;
+	long long   assignNs;
+	long long   startNs;
+	long long   doneNs;
+	long long   errors;
+} __attribute__((aligned(CACHE_LINE))) workerSlot_t;
+
+// Control block at the start of the segment (channels follow on the next page) .
+typedef struct
+{
+	long long    channelBytes;
+	long long    dataOffset;
+	workerSlot_t worker[POOL_SIZE];
+	workerSlot_t cold[BURST_SIZE];
+} poolCtl_t;
+
+// Latency statistics .
+typedef struct
+{
+	unsigned int jobs;
+	long long    errors;
+	long long    latencyTotalNs;
+	long long    latencyMaxNs;
+	long long    serviceTotalNs;
+	long long    serviceMaxNs;
+} jobStats_t;
+
+// Local variables .
+static int childPid = 0;
+static int semid = -1;
+static volatile long long touchSink;
+
+// Callback linked to SIGINT signal .
+void endProcessesSignaller (int sig_num)
+{
+	if (childPid == 0)
+	{
+		// Child kill request .
+		printf("Child kill request (pid %d)\n", (int) getpid());
+		printf("Child killing...\n");
+		kill(getpid(), SIGUSR1);
+	}
+	else
+	{
+		// Father kill request: also the workers are killed (same process group) .
+		printf("Father kill request (pid %d)\n", (int) getpid());
+		printf("Workers killing...\n");
+		signal(SIGUSR1, SIG_IGN);
+		kill(0, SIGUSR1);
+		printf("Father killing...\n");
+		signal(SIGUSR1, SIG_DFL);
+		kill(getpid(), SIGUSR1);
+	}
+}
+
+// Monotonic time in nanoseconds .
+static long long timeNowNs (void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (long long) ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+// Memory creation .
+static int sharedMemCreation (key_t key, size_t size)
+{
+	struct shmid_ds shmds;
+
+	int shmid = shmget(key, size, 0666 | IPC_CREAT);
+
+	if (shmid >= 0)
+	{
+		// Info request .
+		if (shmctl(shmid, IPC_STAT, &shmds) == 0)
+		{
+			printf("%d bytes size shared memory created\n", (int) shmds.shm_segsz);
+		}
+		else
+		{
+			printf("shmctl error = %d\n", errno);
+		}
+	}
+	else
+	{
+		printf("PARENT: shared memory segment not found.\n");
+		exit(-1);
+	}
+
+	return shmid;
+}
+
+// Memory context attaching (quiet: workers attach many times) .
+static bool sharedMemAttach (int shmid, int role, poolCtl_t * * ptPtMem)
+{
+	// Attach shmid memory .
+	*ptPtMem = (poolCtl_t *) shmat(shmid, (const void *)0, 0);
+
+	if (*ptPtMem == (poolCtl_t *) -1)
+	{
+		printf("%s: shmat error = %d\n",((role == 0) ? "PARENT" : " CHILD"), errno);
+		return false;
+	}
+
+	return true;
+}
+
+// Memory context detaching .
+static void sharedMemDetaches(poolCtl_t * ptMem, int shmid, int role)
+{
+	struct shmid_ds shmds;
+
+	if (shmdt(ptMem) == -1)
+	{
+		printf("%s: memory detaching error(%d)\n", ((role == 0) ? "PARENT" : " CHILD"), errno);
+	}
+	else if (role == 0)
+	{
+		// Update info .
+		if(shmctl(shmid, IPC_STAT, &shmds) == 0)
+		{
+			printf("%s: memory (created by pid %d) detached (currently remaining %d attached)\n", ((role == 0) ? "PARENT" : " CHILD"), (int) shmds.shm_cpid, (int) shmds.shm_nattch);
+		}
+		else
+		{
+			printf("%s: shmctl error=%d\n", ((role == 0) ? "PARENT" : " CHILD"), errno);
+		}
+	}
+}
+
+// Semaphore set creation: one assignment semaphore per worker plus the done counter, all zero .
+static int semCreate (key_t key)
+{
+	unsigned short value[POOL_SIZE + 1];
+	int id;
+
+	memset(value, 0, sizeof(value));
+
+	id = semget(key, POOL_SIZE + 1, 0666 | IPC_CREAT);
+
+	if ((id == -1) || (semctl(id, 0, SETALL, value) == -1))
+	{
+		printf("Semaphore creation error (%d)\n", errno);
+		exit(-1);
+	}
+
+	printf("Semaphore set %d has been created (%d semaphores)\n", id, POOL_SIZE + 1);
+
+	return id;
+}
+
+// Semaphore set removing .
+static void semDelete (int id)
+{
+	if (semctl(id, 0, IPC_RMID) != -1)
+	{
+		printf("Semaphore set %d removed.\n", id);
+	}
+}
+
+// System V semaphore operation (timeout in ms, 0 blocks): false on timeout .
+static bool semOperation (int num, int op, long long timeoutMs, int role)
+{
+	struct sembuf sb;
+	struct timespec timeout;
+
+	sb.sem_num = num;
+	sb.sem_op = op;
+	sb.sem_flg = 0;
+
+	timeout.tv_sec = timeoutMs / 1000;
+	timeout.tv_nsec = (timeoutMs % 1000) * NSEC_PER_MS;
+
+	if ( semtimedop(semid, &sb, 1, (timeoutMs > 0) ? &timeout : NULL) == -1 )
+	{
+		if (errno == EAGAIN)
+		{
+			return false;
+		}
+
+		printf("%s: semaphore %d.%d operation failed (%d).\n", ((role == 0) ? "PARENT" : " CHILD"), semid, num, errno);
+		exit(-1);
+	}
+
+	return true;
+}
+
+// Channel data area .
+static long long * channelData (poolCtl_t * ctl, int channel)
+{
+	return (long long *) ((char *) ctl + ctl->dataOffset + channel * ctl->channelBytes);
+}
+
+// Page tables prefault of the whole mapping (touch loop when the kernel lacks MADV_POPULATE_READ) .
+static void mappingPrefault (poolCtl_t * ctl, size_t size)
+{
+	long pageSize = sysconf(_SC_PAGESIZE);
+	size_t i;
+
+	if (madvise(ctl, size, MADV_POPULATE_READ) == 0)
+	{
+		return;
+	}
+
+	for (i=0; i < size; i += pageSize)
+	{
+		touchSink += ((volatile char *) ctl)[i];
+	}
+}
+
+// Channel consumption: every value checked against the assigned pattern .
+static void channelConsume (poolCtl_t * ctl, workerSlot_t * slot)
+{
+	long long * data = channelData(ctl, slot->channel);
+	long long items = ctl->channelBytes / sizeof(long long);
+	long long i;
+
+	slot->startNs = timeNowNs();
+	slot->errors = 0;
+
+	for (i=0; i < items; i++)
+	{
+		if (data[i] != i + slot->pattern)
+		{
+			slot->errors++;
+		}
+	}
+
+	slot->doneNs = timeNowNs();
+}
+
+// Pool worker: attach and prefault once, then serve assignments until the jobs quota .
+static void workerRun (size_t size, int worker)
+{
+	poolCtl_t * ctl;
+	workerSlot_t * slot;
+	int shmid;
+	int supervisorPid = getppid();
+
+	// Own attach as a cold consumer would do, then every page mapped before the first job .
+	shmid = shmget(SHARED_MEM_ID, 0, 0);
+
+	if ((shmid == -1) || !sharedMemAttach(shmid, 1, &ctl))
+	{
+		exit(-1);
+	}
+
+	mappingPrefault(ctl, size);
+
+	slot = &ctl->worker[worker];
+	atomic_store(&slot->state, WORKER_READY);
+
+	while (slot->jobs < WORKER_JOBS)
+	{
+		// Bounded assignment wait: an orphan worker (supervisor dead) gives up and removes the IPC objects .
+		while (!semOperation(worker, -1, STALL_THRESHOLD_MS, 1))
+		{
+			if (getppid() != supervisorPid)
+			{
+				printf(" CHILD: worker %d, supervisor (pid %d) is dead.\n", worker, supervisorPid);
+				shmctl(shmid, IPC_RMID, 0);
+				semDelete(semid);
+				exit(-1);
+			}
+		}
+
+		// Negative channel: pool shutdown .
+		if (slot->channel < 0)
+		{
+			break;
+		}
+
+		channelConsume(ctl, slot);
+		slot->jobs++;
+
+		// Results are in place before the state change and the done signal .
+		atomic_store(&slot->state, (slot->jobs < WORKER_JOBS) ? WORKER_READY : WORKER_EXITED);
+		semOperation(SEM_DONE, 1, 0, 1);
+	}
+
+	sharedMemDetaches(ctl, shmid, 1);
+
+	exit(0);
+}
+
+// Worker creation in a pool slot .
+static void workerSpawn (poolCtl_t * ctl, size_t size, int worker)
+{
+	workerSlot_t * slot = &ctl->worker[worker];
+	int retFork;
+
+	memset(slot, 0, sizeof(workerSlot_t));
+	atomic_store(&slot->state, WORKER_STARTING);
+
+	// A worker dead between the post and its semop leaves a stale assignment: the new one starts from zero .
+	if (semctl(semid, worker, SETVAL, 0) == -1)
+	{
+		printf("PARENT: semaphore %d.%d reset failed (%d)\n", semid, worker, errno);
+		exit(-1);
+	}
+
+	fflush(stdout);
+	retFork = fork();
+
+	if (retFork == 0)
+	{
+		childPid = 0;
+		workerRun(size, worker);
+	}
+	else if (retFork > 0)
+	{
+		slot->pid = retFork;
+		childPid = retFork;
+	}
+	else
+	{
+		printf("PARENT: error trying to fork() (%d)\n", errno);
+		exit(-1);
+	}
+}
+
+// Job results update .
+static void statsAdd (jobStats_t * st, const workerSlot_t * slot)
+{
+	long long latencyNs = slot->startNs - slot->assignNs;
+	long long serviceNs = slot->doneNs - slot->startNs;
+
+	st->jobs++;
+	st->errors += slot->errors;
+	st->latencyTotalNs += latencyNs;
+	st->serviceTotalNs += serviceNs;
+
+	if (latencyNs > st->latencyMaxNs)
+	{
+		st->latencyMaxNs = latencyNs;
+	}
+
+	if (serviceNs > st->serviceMaxNs)
+	{
+		st->serviceMaxNs = serviceNs;
+	}
+}
+
+// Finished job collection: the slot is reset once counted, so it is counted once whoever collects it first .
+static void jobCollect (jobStats_t * st, workerSlot_t * slot)
+{
+	if (slot->doneNs != 0)
+	{
+		statsAdd(st, slot);
+		slot->doneNs = 0;
+	}
+}
+
+// Exited workers collection and synchronous replacement (supervisor loop, between assignments): returns the jobs lost .
+// The last job of an exited worker is counted before workerSpawn resets its slot .
+static int poolReap (poolCtl_t * ctl, size_t size, unsigned int * replaced, jobStats_t * st)
+{
+	int pid, status, worker, lost = 0;
+
+	while ((pid = waitpid(-1, &status, WNOHANG)) > 0)
+	{
+		for (worker=0; worker < POOL_SIZE; worker++)
+		{
+			if (ctl->worker[worker].pid == pid)
+			{
+				// A worker dead while busy never signals its job done .
+				if (atomic_load(&ctl->worker[worker].state) == WORKER_BUSY)
+				{
+					printf("PARENT: worker %d (pid %d) died on channel %d\n", worker, pid, ctl->worker[worker].channel);
+					lost++;
+				}
+
+				jobCollect(st, &ctl->worker[worker]);
+				workerSpawn(ctl, size, worker);
+				(*replaced)++;
+				break;
+			}
+		}
+	}
+
+	return lost;
+}
+
+// Statistics report .
+static void statsReport (const char * name, const jobStats_t * st)
+{
+	if (st->jobs == 0)
+	{
+		return;
+	}
+
+	printf("%-12s %5u %12lld %12lld %12lld %12lld %7lld\n", name, st->jobs,
+	       st->latencyTotalNs / st->jobs / 1000, st->latencyMaxNs / 1000,
+	       st->serviceTotalNs / st->jobs / 1000, st->serviceMaxNs / 1000, st->errors);
+}
+
+// Channel fill: the incoming burst data .
+static void channelFill (poolCtl_t * ctl, int channel, long long pattern)
+{
+	long long * data = channelData(ctl, channel);
+	long long items = ctl->channelBytes / sizeof(long long);
+	long long i;
+
+	for (i=0; i < items; i++)
+	{
+		data[i] = i + pattern;
+	}
+}
+
+// Cold consumers burst: fork, attach and first touch on the assignment path of every channel .
+static void coldBurst (poolCtl_t * ctl, int burst, long long * ptPattern, jobStats_t * st)
+{
+	workerSlot_t * slot;
+	poolCtl_t * mem;
+	int retFork, shmid, n;
+
+	for (n=0; n < BURST_SIZE; n++)
+	{
+		slot = &ctl->cold[n];
+		memset(slot, 0, sizeof(workerSlot_t));
+		slot->channel = (burst * BURST_SIZE + n) % CHANNEL_NUMBER;
+		slot->pattern = ++(*ptPattern);
+		channelFill(ctl, slot->channel, slot->pattern);
+	}
+
+	for (n=0; n < BURST_SIZE; n++)
+	{
+		fflush(stdout);
+		ctl->cold[n].assignNs = timeNowNs();
+		retFork = fork();
+
+		if (retFork == 0)
+		{
+			childPid = 0;
+
+			shmid = shmget(SHARED_MEM_ID, 0, 0);
+
+			if ((shmid == -1) || !sharedMemAttach(shmid, 1, &mem))
+			{
+				exit(-1);
+			}
+
+			channelConsume(mem, &mem->cold[n]);
+			sharedMemDetaches(mem, shmid, 1);
+
+			exit(0);
+		}
+		else if (retFork < 0)
+		{
+			printf("PARENT: error trying to fork() (%d)\n", errno);
+			exit(-1);
+		}
+
+		childPid = retFork;
+	}
+
+	while (wait(NULL) > 0)
+	{
+	}
+
+	for (n=0; n < BURST_SIZE; n++)
+	{
+		statsAdd(st, &ctl->cold[n]);
+	}
+}
+
+// Main routine: usage SharedMemoryWorkerPool [channel MB] .
+int main(int argc, char * argv[])
+{
+	int shmid, worker, burst, n, pending;
+	int assigned[BURST_SIZE];
+	long long channelMb = (argc > 1) ? atoll(argv[1]) : CHANNEL_MB;
+	long long pattern = OFFSET;
+	long pageSize = sysconf(_SC_PAGESIZE);
+	size_t size, dataOffset;
+	poolCtl_t * ctl = NULL;
+	jobStats_t coldStats, warmStats;
+	unsigned int replaced = 0, notReady = 0, lost = 0;
+	workerSlot_t * slot;
+
+	if (channelMb <= 0)
+	{
+		printf("Usage: %s [channel MB]\n", argv[0]);
+		return -1;
+	}
+
+	memset(&coldStats, 0, sizeof(coldStats));
+	memset(&warmStats, 0, sizeof(warmStats));
+
+	dataOffset = ((sizeof(poolCtl_t) + pageSize - 1) / pageSize) * pageSize;
+	size = dataOffset + CHANNEL_NUMBER * channelMb * 1024 * 1024;
+
+	printf("%d pool workers (%d jobs each), %d channels of %lld MB\n", POOL_SIZE, WORKER_JOBS, CHANNEL_NUMBER, channelMb);
+
+	// Signal callback registration .
+	signal(SIGINT, endProcessesSignaller);
+
+	// Shared memory and semaphores create .
+	shmid = sharedMemCreation(SHARED_MEM_ID, size);
+	semid = semCreate(SEM_ID);
+
+	if (!sharedMemAttach(shmid, 0, &ctl))
+	{
+		exit(-1);
+	}
+
+	// Whole segment written once: the pages exist, only the per process mapping is missing .
+	memset(ctl, 0, size);
+	ctl->channelBytes = channelMb * 1024 * 1024;
+	ctl->dataOffset = dataOffset;
+
+	// Cold consumers: one fork + shmget + shmat + page faults per assignment .
+	for (burst=0; burst < COLD_BURST_NUMBER; burst++)
+	{
+		coldBurst(ctl, burst, &pattern, &coldStats);
+	}
+
+	// Warm pool creation: attach and prefault happen here, before any data .
+	for (worker=0; worker < POOL_SIZE; worker++)
+	{
+		workerSpawn(ctl, size, worker);
+	}
+
+	for (burst=0; burst < BURST_NUMBER; burst++)
+	{
+		// Burst data arrives on some channels .
+		for (n=0; n < BURST_SIZE; n++)
+		{
+			channelFill(ctl, (burst * BURST_SIZE + n) % CHANNEL_NUMBER, pattern + 1 + n);
+		}
+
+		// Each channel goes to a ready worker (waiting only while replacements are still prefaulting) .
+		for (n=0; n < BURST_SIZE; n++)
+		{
+			for (worker=0; worker < POOL_SIZE; worker++)
+			{
+				if (atomic_load(&ctl->worker[(burst + n + worker) % POOL_SIZE].state) == WORKER_READY)
+				{
+					break;
+				}
+			}
+
+			if (worker == POOL_SIZE)
+			{
+				notReady++;
+				lost += poolReap(ctl, size, &replaced, &warmStats);
+				sched_yield();
+				n--;
+				continue;
+			}
+
+			worker = (burst + n + worker) % POOL_SIZE;
+			slot = &ctl->worker[worker];
+
+			// A worker quick enough can be picked twice in a burst: its previous job is counted first .
+			jobCollect(&warmStats, slot);
+			slot->channel = (burst * BURST_SIZE + n) % CHANNEL_NUMBER;
+			slot->pattern = ++pattern;
+			atomic_store(&slot->state, WORKER_BUSY);
+
+			slot->assignNs = timeNowNs();
+			semOperation(worker, 1, 0, 0);
+
+			assigned[n] = worker;
+		}
+
+		// Burst completion, exited workers replaced meanwhile .
+		pending = BURST_SIZE;
+
+		while (pending > 0)
+		{
+			if (semOperation(SEM_DONE, -1, REAP_INTERVAL_MS, 0))
+			{
+				pending--;
+			}
+			else
+			{
+				n = poolReap(ctl, size, &replaced, &warmStats);
+				lost += n;
+				pending -= n;
+			}
+		}
+
+		// Jobs of workers already replaced were collected by poolReap .
+		for (n=0; n < BURST_SIZE; n++)
+		{
+			jobCollect(&warmStats, &ctl->worker[assigned[n]]);
+		}
+
+		lost += poolReap(ctl, size, &replaced, &warmStats);
+	}
+
+	// Pool shutdown: live workers get the negative channel .
+	for (worker=0; worker < POOL_SIZE; worker++)
+	{
+		while (atomic_load(&ctl->worker[worker].state) == WORKER_STARTING)
+		{
+			sched_yield();
+		}
+
+		if (atomic_load(&ctl->worker[worker].state) == WORKER_READY)
+		{
+			ctl->worker[worker].channel = -1;
+			semOperation(worker, 1, 0, 0);
+		}
+	}
+
+	while (wait(NULL) > 0)
+	{
+	}
+
+	childPid = 0;
+
+	// Report .
+	printf("\n%-12s %5s %12s %12s %12s %12s %7s\n", "consumer", "jobs", "assign us", "max us", "service us", "max us", "errors");
+	statsReport("cold fork", &coldStats);
+	statsReport("warm pool", &warmStats);
+	printf("\nPARENT: %u workers replaced, %u assignments waited for a ready worker, %u jobs lost\n", replaced, notReady, lost);
+
+	semDelete(semid);
+
+	// Detaching memory .
+	sharedMemDetaches(ctl, shmid, 0);
+
+	// Removing memory .
+	if (shmctl( shmid, IPC_RMID, 0 ) == 0)
+	{
+		printf( "PARENT: memory segment removed\n");
+	}
+	else
+	{
+		printf( "PARENT: memory segment removing fail!\n" );
+	}
+
+	printf("PARENT: Exiting...\n");
+	fflush(stdout);
+
+	return 0;
+}